@@ -0,0 +1,35 @@
+#pragma once
+#include <stdint.h>
+
+//==================== レイテンシ計測ハーネス ====================
+// 1: 予備GPIOから PIN_RESET / PIN_INT をループバック駆動し、
+//    INT→KILL と RESET立下り→KILL解放 のレイテンシ分布をシリアルへ出力する
+#ifndef SUPERVISOR_BENCH
+  #define SUPERVISOR_BENCH 0
+#endif
+
+// 1: 計測中は SoftAP を立て、core 0 から無線の送信キューが空く限りブロードキャストのデータフレームを
+//    送り続ける（無線タスク・割り込みが core 0 を占める状態での計測。周囲のチャネルを占有するので計測台でのみ使う）
+//    計測側も core 0 で動き、1回の計測窓の最初の数百µsだけは core 0 の割り込みを止める
+#ifndef BENCH_WIFI_LOAD
+  #define BENCH_WIFI_LOAD 0
+#endif
+#ifndef BENCH_WIFI_CHANNEL
+  #define BENCH_WIFI_CHANNEL 13
+#endif
+
+// 配線: drvReset -> PIN_RESET, drvInt -> PIN_INT（KILLは PIN_KILL のパッドを直接読む）
+struct BenchConfig {
+  int      pinKill;
+  int      drvReset;
+  int      drvInt;
+  int      pinScratch;      // 未接続の予備ピン（GPIO操作コストの比較用、-1で省略）
+  uint32_t cycles;          // 疑似電源ボタン操作の回数
+  uint32_t resetSettleUs;   // RESET立上り後、KILLが許可されるまで待つ時間
+  uint32_t killHoldUs;      // KILLアサート後、RESETを落とすまで待つ時間（最低保持より長く）
+  uint32_t cycleGapUs;      // サイクル間隔（INTデバウンスより長く）
+  uint32_t timeoutUs;       // 1回の応答待ちの上限
+};
+
+// 計測タスクを起動（監視タスクとは別コアで動かす）
+void benchBegin(const BenchConfig& cfg);
@@ -0,0 +1,29 @@
+#pragma once
+#include <stdint.h>
+#include <Arduino.h>
+
+//==================== バイナリ応答フレーム ====================
+// シリアルコマンドへのバイナリ応答の共通形式（リトルエンディアン）:
+//   u32 magic | ペイロード | u16 sum（magic以降の全バイトの単純和）
+class FrameWriter {
+ public:
+  FrameWriter(Print& out, uint32_t magic) : out_(out) {
+    put(&magic, sizeof(magic));
+  }
+
+  void put(const void* data, size_t len) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < len; ++i) sum_ += p[i];
+    out_.write(p, len);
+  }
+
+  void finish() {
+    const uint16_t sum = sum_;
+    out_.write(reinterpret_cast<const uint8_t*>(&sum), sizeof(sum));
+    out_.flush();
+  }
+
+ private:
+  Print&   out_;
+  uint16_t sum_ = 0;
+};
@@ -0,0 +1,53 @@
+#pragma once
+#include <stdint.h>
+#include <Arduino.h>
+#include <esp_attr.h>
+#include "supervisor_config.h"
+
+//==================== 起動前後のエッジ捕捉 ====================
+// (1) RESET=H の開始時刻を RTC_NOINIT に RTCタイマ基準で残し、MCUだけの再起動後も
+//     「この起動より前からHだった」ことと本当の開始時刻を引き継ぐ
+// (2) INT立下りをPCNTで数え、割り込み有効化までの取りこぼしを拾う。計数の開始は
+//     SUPERVISOR_FAST_BOOT では C++静的初期化（main.cpp の早期初期化コンストラクタ）、それ以外は pinsBegin()。
+//     それより前（ROM・2段目ブートローダ・静的初期化前のアプリ起動処理）の立下りは数えられない
+// 引き継ぐのはMCUだけの再起動（BootKind::Warm）のみ。電源投入・ブラウンアウトでは
+// RTCメモリが残っていてもRESETの履歴は当てにならないので記録ごと捨てる。
+// RTCタイマは電源投入/チップリセットで0に戻るので、その場合も記録ごと無効になる。
+// MCUのリセット中（ファームウェアが走っていない間）のRESET変化は捕捉できない。
+
+constexpr uint8_t BOOT_CAPTURE_CHANNELS = 16;  // Supervisor の CHANNEL 上限と同じ
+constexpr uint8_t BOOT_CAPTURE_PCNT_UNITS = 4; // ESP32-S3 のPCNTユニット数（超えるチャネルはINT計数なし）
+
+struct BootCaptureState {
+  uint32_t magic;
+  uint32_t reserved;
+  int64_t  resetHighSinceRtcUs[BOOT_CAPTURE_CHANNELS]; // 0ならL
+};
+
+// 起動の種類（ROMが保持するリセット要因から判定）
+enum class BootKind : uint8_t {
+  Cold = 0, // 電源投入・ブラウンアウト・電源グリッチ（MCUの電源が落ちた）
+  Warm,     // ソフトウェア・ウォッチドッグ・パニック・USB等によるMCUだけの再起動
+};
+
+extern BootCaptureState g_bootCapture;
+extern int64_t          g_rtcOffsetUs; // RTCタイマ[µs] - esp_timer[µs]（起動時に1回求める）
+
+// 起動時に1回: 起動の種類を判定し、RTC基準のオフセットを求め、無効な記録を捨てる
+void bootCaptureBegin();
+// bootCaptureBegin() で判定した起動の種類
+BootKind bootCaptureKind();
+
+// RESETレベル変化の記録（ISRからも可。high=true の時は立上り時刻を渡す）
+inline void IRAM_ATTR bootCaptureResetEdge(uint8_t channel, usec_t atUs, bool high) {
+  g_bootCapture.resetHighSinceRtcUs[channel] = high ? g_rtcOffsetUs + atUs : 0;
+}
+
+// 前回の起動から RESET=H が続いていれば、その開始時刻（esp_timer基準、負もあり得る）を返す
+bool bootCaptureResetHighSince(uint8_t channel, usec_t& sinceUs);
+
+// INT立下りの計数を開始（PCNTユニット = チャネル番号）。レジスタ書き込みのみで静的初期化からも可、
+// 計数中なら何もしない（早期開始からの計数を pinsBegin() で消さない）
+void bootCaptureIntBegin(uint8_t channel, int pin);
+// 計数を止めて開始からの立下り回数を返す（計数していなければ0）
+uint32_t bootCaptureIntTake(uint8_t channel);
@@ -0,0 +1,25 @@
+#pragma once
+#include <stdint.h>
+#include <Arduino.h>
+
+//==================== 高速起動 ====================
+// 1: Arduinoコア初期化より前（C++静的初期化）にKILLをアイドルへ固定し、シリアル等の準備は割り込み登録の後へ回す
+#ifndef SUPERVISOR_FAST_BOOT
+  #define SUPERVISOR_FAST_BOOT 0
+#endif
+
+// 起動の節目（リセットから監視開始までの計測用）
+enum class BootStage : uint8_t {
+  EarlyInit = 0,  // 静的初期化でKILLをアイドルに固定（SUPERVISOR_FAST_BOOT のみ）
+  SetupEntry,     // setup() 入口
+  Armed,          // INT/RESET割り込み有効化完了
+  Count,
+};
+
+// 節目を記録（同じ節目は最初の1回のみ）。時刻の読み出しと静的配列への書き込みだけなので静的初期化からも可
+void bootMark(BootStage stage);
+// 記録をテキスト1行で出力
+//   kind: cold（電源投入・ブラウンアウト）/ warm（MCUだけの再起動）、reason: esp_reset_reason_t
+//   rtc: RTCタイマ基準（電源投入/チップリセットから、ROM・ブートローダを含む）
+//   app: esp_timer 基準（アプリ起動から）
+void bootReport(Print& out);
@@ -0,0 +1,128 @@
+#pragma once
+#include <stdint.h>
+#include <Arduino.h>
+#include <esp_attr.h>
+#include "supervisor_config.h"
+
+//==================== CPU周波数の動的切り替え ====================
+// 1: 待機中はCPUを DFS_MIN_MHZ まで落とし、監視が動いている間だけ DFS_MAX_MHZ に上げる
+//    （esp_pm のCPU_FREQ_MAXロック。CONFIG_PM_ENABLE のフレームワークが前提）
+#ifndef SUPERVISOR_DFS
+  #define SUPERVISOR_DFS 0
+#endif
+#ifndef DFS_MAX_MHZ
+  #define DFS_MAX_MHZ 240
+#endif
+// 80MHz未満ではAPBクロックも下がり、APB基準のタイミング（MCPWMキャプチャ、PCNTフィルタ）がずれる
+#ifndef DFS_MIN_MHZ
+  #define DFS_MIN_MHZ 80
+#endif
+// 計測用: 最大周波数を要求している間だけHにする予備GPIO（-1: 使わない）。
+// 電流計・スコープのゲート/トリガに使い、モード毎の平均電流と、INT→KILL に周波数切り替えが
+// 足す遅れ（このピンの立上りからKILLまで）を外部で測る。ファームウェアは電流を測れない
+// （手順と結果の表は docs/measurements.md）
+#ifndef DFS_MARKER_PIN
+  #define DFS_MARKER_PIN -1
+#endif
+
+// ロックを保持する理由（理由毎に1つのロック、取得/解放は回数で対になる）
+enum class DfsHold : uint8_t {
+  Event = 0, // ISRがイベントを積んでから監視タスクが処理し終えるまで
+  Kill,      // KILLアサート中（チャネル毎に1回）
+  Led,       // LEDパターン再生中（チャネル毎に1回）
+  Count,
+};
+
+#if SUPERVISOR_DFS
+#include <esp_pm.h>
+#include <soc/gpio_struct.h>
+
+static_assert(DFS_MARKER_PIN < 32, "DFS_MARKER_PIN must be in GPIO bank 0 (register access from ISRs)");
+
+extern esp_pm_lock_handle_t g_dfsLocks[static_cast<size_t>(DfsHold::Count)]; // 未作成なら nullptr
+extern volatile bool        g_dfsEventHeld;
+
+// 最大周波数の滞在時間（理由毎と、いずれかを保持している時間）。書き込みは g_dfsMux 内
+struct DfsResidency {
+  uint32_t depth[static_cast<size_t>(DfsHold::Count)];    // 保持数（Kill/Led はチャネル数まで重なる）
+  int64_t  sinceUs[static_cast<size_t>(DfsHold::Count)];  // 0→1 にした時刻
+  uint32_t acquires[static_cast<size_t>(DfsHold::Count)]; // 0→1 の回数
+  uint64_t heldUs[static_cast<size_t>(DfsHold::Count)];   // 1以上だった累計（終わった区間の分）
+  uint32_t anyDepth;
+  int64_t  anySinceUs;
+  uint64_t boostedUs;                                      // いずれかを保持していた累計
+  int64_t  clearedAtUs;                                    // 累計の起点
+};
+extern DfsResidency g_dfsResidency;
+extern portMUX_TYPE g_dfsMux;
+
+inline void IRAM_ATTR dfsMarker(bool on) {
+  if (DFS_MARKER_PIN < 0) return;
+  if (on) GPIO.out_w1ts = 1u << (DFS_MARKER_PIN & 31);
+  else    GPIO.out_w1tc = 1u << (DFS_MARKER_PIN & 31);
+}
+
+// ISR / critical section からも呼べる（esp_pm_lock_* はIRAM常駐）
+inline void IRAM_ATTR dfsAcquire(DfsHold hold) {
+  const size_t i = static_cast<size_t>(hold);
+  portENTER_CRITICAL_SAFE(&g_dfsMux);
+  DfsResidency& r = g_dfsResidency;
+  if (r.depth[i]++ == 0) {
+    r.sinceUs[i] = nowUs();
+    ++r.acquires[i];
+  }
+  if (r.anyDepth++ == 0) {
+    r.anySinceUs = nowUs();
+    dfsMarker(true); // 切り替え要求の前に（外部計測の起点）
+  }
+  portEXIT_CRITICAL_SAFE(&g_dfsMux);
+  esp_pm_lock_handle_t lock = g_dfsLocks[i];
+  if (lock != nullptr) esp_pm_lock_acquire(lock);
+}
+
+inline void IRAM_ATTR dfsRelease(DfsHold hold) {
+  const size_t i = static_cast<size_t>(hold);
+  esp_pm_lock_handle_t lock = g_dfsLocks[i];
+  if (lock != nullptr) esp_pm_lock_release(lock);
+  portENTER_CRITICAL_SAFE(&g_dfsMux);
+  DfsResidency& r = g_dfsResidency;
+  const int64_t now = nowUs();
+  if (r.depth[i] > 0 && --r.depth[i] == 0) r.heldUs[i] += now - r.sinceUs[i];
+  if (r.anyDepth > 0 && --r.anyDepth == 0) {
+    r.boostedUs += now - r.anySinceUs;
+    dfsMarker(false);
+  }
+  portEXIT_CRITICAL_SAFE(&g_dfsMux);
+}
+
+// ISR側: 監視タスクへ通知する時に呼ぶ（処理待ちの間は1回分だけ保持）
+inline void IRAM_ATTR dfsHoldEventFromIsr() {
+  if (g_dfsEventHeld) return;
+  g_dfsEventHeld = true;
+  dfsAcquire(DfsHold::Event);
+}
+
+// 監視タスク側: イベント処理の前に呼び、保持していれば処理後に dfsRelease(DfsHold::Event)
+// （ISRと同じコアで呼ぶ。取り出した後のISRは新たに保持するので処理中の取りこぼしは無い）
+inline bool dfsTakeEventHold() {
+  noInterrupts();
+  bool held = g_dfsEventHeld;
+  g_dfsEventHeld = false;
+  interrupts();
+  return held;
+}
+#else
+inline void dfsAcquire(DfsHold) {}
+inline void dfsRelease(DfsHold) {}
+inline void dfsHoldEventFromIsr() {}
+inline bool dfsTakeEventHold() { return false; }
+#endif
+
+// 周波数範囲を設定してロックを作成（最初のロック使用より前、setup() の先頭で1回）
+void dfsBegin();
+// 最大周波数の滞在をテキスト1行で出力（保持中の区間も今までの分を含める）
+//   "dfs min_mhz=.. max_mhz=.. window_us=.. boosted_us=.. boost_ppm=.. event=回数/µs kill=.. led=.."
+//   SUPERVISOR_DFS でなければ "dfs disabled"
+void dfsReport(Print& out);
+// 滞在の累計を消去（保持数はそのまま）
+void dfsClear();
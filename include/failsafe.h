@@ -0,0 +1,57 @@
+#pragma once
+#include <stdint.h>
+#include "supervisor_config.h"
+
+//==================== フェイルセーフ ====================
+// 監視タスクや esp_timer タスクが止まっても KILL が張り付いたり、アサートされずに終わらないための二重化
+//   (1) 監視タスクをタスクウォッチドッグへ登録（止まればKILLをアイドルへ戻してパニック→再起動）
+//   (2) ハードウェアタイマ（タイマグループ）の周期割り込みで、タイムアウトを過ぎたKILLを強制解放し、
+//       監視タスクが処理しないKILL要求を代わりにアサートする（タスク・esp_timer に依存しない）
+//   (3) 強制動作とウォッチドッグの理由を RTC_NOINIT と永続トレースに残し、再起動後に 'B' で確認できる
+// 0 にすると (1)(2) を行わない（監視タスクはイベントが来るまで無期限に待つ）
+#ifndef SUPERVISOR_WATCHDOG
+  #define SUPERVISOR_WATCHDOG 1
+#endif
+
+constexpr uint32_t WATCHDOG_TIMEOUT_S         = 5;     // タスクウォッチドッグ（発火でパニック）
+constexpr uint32_t WATCHDOG_FEED_MS           = 1000;  // 監視タスクの最長待ち（この周期で給餌）
+constexpr uint32_t BACKSTOP_PERIOD_US         = 10000; // ハードウェアタイマの点検周期
+constexpr usec_t   BACKSTOP_RELEASE_MARGIN_US = 20000; // KILLのタイムアウトをこれだけ過ぎたら強制解放
+constexpr usec_t   BACKSTOP_ASSERT_US         = 50000; // KILL要求がこれだけ処理されなければ強制アサート
+constexpr int      BACKSTOP_CORE              = 0;     // 監視タスクと別のコアで割り込みを受ける
+
+enum class FailsafeReason : uint8_t {
+  None            = 0,
+  BackstopRelease = 1, // タイムアウトを過ぎたKILLをハードウェアタイマで解放
+  BackstopAssert  = 2, // 処理されないKILL要求をハードウェアタイマでアサート
+  TaskWatchdog    = 3, // タスクウォッチドッグ発火（直後にパニックで再起動）
+};
+
+constexpr uint8_t FAILSAFE_NO_CHANNEL = 0xFF;
+
+// RTC_NOINIT の記録（電源投入・ブラウンアウトで消え、MCUだけの再起動では引き継ぐ）
+struct FailsafeRecord {
+  uint32_t magic;
+  uint32_t count;       // 強制動作/ウォッチドッグ発火の累計
+  uint8_t  lastReason;  // FailsafeReason
+  uint8_t  lastChannel; // FAILSAFE_NO_CHANNEL: チャネルに依らない
+  uint16_t reserved;
+  int64_t  lastRtcUs;   // RTCタイマ基準の時刻
+};
+
+// 起動時に1回（bootCaptureBegin() の後）。無効な記録を初期化する
+void failsafeBegin();
+
+// 強制動作の記録（ISRからも可）
+void failsafeNote(FailsafeReason reason, uint8_t channel);
+
+// ハードウェアタイマの周期割り込みを開始（isr は IRAM、戻り値はタスク切り替え要求）
+void failsafeBackstopBegin(bool (*isr)(void*));
+
+// タスクウォッチドッグ: 呼び出したタスクを登録 / 給餌
+// hook はウォッチドッグ割り込みからパニック直前に呼ばれる（IRAM、KILLをアイドルへ戻す）
+void failsafeWatchdogAdd(void (*hook)());
+void failsafeWatchdogFeed();
+
+// 記録を1行で出力（"failsafe count=N last=... ch=... rtc_us=..."）
+void failsafeReport(Print& out);
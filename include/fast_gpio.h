@@ -0,0 +1,42 @@
+#pragma once
+#include <stdint.h>
+#include <Arduino.h>
+#include <soc/gpio_struct.h>
+#include <soc/gpio_periph.h>
+#include <soc/io_mux_reg.h>
+
+//==================== 高速GPIO ====================
+// GPIO0〜31 のレジスタ直アクセス。Arduino HAL（ピン番号検証・GPIOマトリクス再設定・ロック）を
+// 経由せず、読み出しは GPIO.in の1ロード、切り替えは W1TS/W1TC への1ストアで済む。
+// ISRからも呼べるよう always_inline で呼び出し元へ展開する。
+// 方向・プル・機能の初期設定は従来どおり pinMode() で行い、以後の操作だけをここで行う。
+#define FAST_GPIO_INLINE inline __attribute__((always_inline))
+
+template <int PIN>
+struct FastGpio {
+  static_assert(PIN >= 0 && PIN < 32, "FastGpio supports GPIO bank 0 (GPIO0-31) only");
+  static constexpr uint32_t MASK = 1u << PIN;
+
+  static FAST_GPIO_INLINE bool high() { return (GPIO.in & MASK) != 0; }
+  static FAST_GPIO_INLINE bool low()  { return (GPIO.in & MASK) == 0; }
+
+  // 出力ラッチ
+  static FAST_GPIO_INLINE void set()   { GPIO.out_w1ts = MASK; }
+  static FAST_GPIO_INLINE void clear() { GPIO.out_w1tc = MASK; }
+
+  // 出力有効/無効（無効時はHi-Z＋pinMode() で設定したプル）
+  // ラッチをアクティブレベルに固定しておけば、オープンドレイン相当の切り替えになる
+  static FAST_GPIO_INLINE void drive()   { GPIO.enable_w1ts = MASK; }
+  static FAST_GPIO_INLINE void release() { GPIO.enable_w1tc = MASK; }
+
+  // 割り込み種別（gpio_int_type_t の値、0で停止）。ハンドラ・有効化の設定はそのまま
+  static FAST_GPIO_INLINE void intType(uint32_t type) { GPIO.pin[PIN].int_type = type; }
+
+  // IO_MUX を直接書いてGPIO機能＋内部プルにする（pinMode() を呼べない静的初期化用。
+  // 出力有効・入力有効などの残りは後の pinMode() に任せる）
+  static FAST_GPIO_INLINE void padPull(bool up) {
+    PIN_FUNC_SELECT(GPIO_PIN_MUX_REG[PIN], PIN_FUNC_GPIO);
+    if (up) { REG_CLR_BIT(GPIO_PIN_MUX_REG[PIN], FUN_PD); REG_SET_BIT(GPIO_PIN_MUX_REG[PIN], FUN_PU); }
+    else    { REG_CLR_BIT(GPIO_PIN_MUX_REG[PIN], FUN_PU); REG_SET_BIT(GPIO_PIN_MUX_REG[PIN], FUN_PD); }
+  }
+};
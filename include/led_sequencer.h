@@ -0,0 +1,184 @@
+#pragma once
+#include <stdint.h>
+#include <Arduino.h>
+#include "supervisor_config.h"
+#include "cpu_dfs.h"
+#include "probe.h"
+
+//==================== LEDパターン ====================
+constexpr uint8_t STARTUP_BLINK_COUNT   = 3;
+constexpr usec_t  STARTUP_BLINK_ON_US   = 120000;  // 「100–150ms」の中庸
+constexpr usec_t  STARTUP_BLINK_OFF_US  = 120000;  // 同上
+constexpr usec_t  POWERDOWN_BLINK_ON_US = 500000;
+
+// LEDパターン表（点灯/消灯と継続時間の列、終了後は消灯）
+struct LedStep {
+  bool   on;
+  usec_t durUs;
+};
+// 起動: 短点灯×3回
+constexpr LedStep LED_PATTERN_POWER_ON[] = {
+  {true,  STARTUP_BLINK_ON_US}, {false, STARTUP_BLINK_OFF_US},
+  {true,  STARTUP_BLINK_ON_US}, {false, STARTUP_BLINK_OFF_US},
+  {true,  STARTUP_BLINK_ON_US},
+};
+static_assert(sizeof(LED_PATTERN_POWER_ON) / sizeof(LedStep) == STARTUP_BLINK_COUNT * 2 - 1,
+              "LED_PATTERN_POWER_ON must match STARTUP_BLINK_COUNT");
+// 電源OFF: やや長い点灯×1回
+constexpr LedStep LED_PATTERN_POWER_OFF[] = {
+  {true,  POWERDOWN_BLINK_ON_US},
+};
+
+// LEDパターン要求（監視タスク→LEDタスク）
+struct LedPattern {
+  const LedStep* steps;
+  uint8_t        len;
+};
+
+// LEDシーケンサ状態（LEDタスク専有、steps==nullptrなら停止中）
+struct LedSequencer {
+  const LedStep* steps = nullptr;
+  uint8_t        len = 0;
+  uint8_t        idx = 0;
+  usec_t         stepAtUs = 0; // 現ステップの開始時刻
+  usec_t         startAtUs = 0; // パターンの開始時刻
+};
+
+constexpr UBaseType_t LED_TASK_PRIO = 1;
+constexpr uint32_t    LED_STACK     = 2048;
+
+//==================== LEDシーケンサ（ノンブロッキング） ====================
+// チャネル毎のLED（Config::PIN_LED < 0 なら全操作が空になる）
+template <typename Config>
+class Led {
+ public:
+  static constexpr bool ENABLED = Config::PIN_LED >= 0;
+
+  static void pinBegin() {
+    if (!ENABLED) return;
+    pinMode(Config::PIN_LED, OUTPUT);
+    set(false);
+  }
+
+  // 要求キュー（長さ1、新しい要求で上書き）とLEDタスクを用意
+  static void begin(BaseType_t core) {
+    if (!ENABLED) return;
+    queue_ = xQueueCreate(1, sizeof(LedPattern));
+    xTaskCreatePinnedToCore(task, "led", LED_STACK, nullptr, LED_TASK_PRIO, &task_, core);
+  }
+
+  static void set(bool on) {
+    if (!ENABLED) return;
+    digitalWrite(Config::PIN_LED, (on == activeHigh_) ? HIGH : LOW);
+  }
+
+  // 極性の変更（初期値は Config::LED_ACTIVE_HIGH）。停止中なら消灯レベルを出し直す
+  static void setActiveHigh(bool activeHigh) {
+    if (!ENABLED || activeHigh == activeHigh_) return;
+    activeHigh_ = activeHigh;
+    if (queue_ == nullptr || idle()) set(false); // begin() 前は再生し得ない
+  }
+
+  // LEDタスクへ要求（実行中のパターンより新しい要求を優先）
+  template <size_t N>
+  static void request(const LedStep (&pattern)[N]) {
+    if (!ENABLED) return;
+    const LedPattern req = {pattern, static_cast<uint8_t>(N)};
+    xQueueOverwrite(queue_, &req);
+  }
+
+  // 再生中でも要求待ちでもない（g_led はLEDタスク所有だが、停止中かどうかの参照のみ）
+  static bool idle() {
+    return !ENABLED || (!busy() && uxQueueMessagesWaiting(queue_) == 0);
+  }
+
+  // 再生し終えた（差し替えで中断した分を含む）パターンの累計時間[µs]（u32の差分で読む）
+  static uint32_t IRAM_ATTR playedUs() {
+    return playedUs_;
+  }
+
+  // その場で再生（制御を他が担っている時だけ使う）
+  template <size_t N>
+  static void playBlocking(const LedStep (&pattern)[N]) {
+    if (!ENABLED) return;
+    const LedPattern p = {pattern, static_cast<uint8_t>(N)};
+    start(p);
+    while (busy()) {
+      delay(static_cast<uint32_t>((remainingUs(nowUs()) + 999) / 1000));
+      tick(nowUs());
+    }
+  }
+
+ private:
+  // パターン開始（実行中のパターンは中断して差し替え）
+  static void start(const LedPattern& pattern) {
+    const usec_t now = nowUs();
+    if (!busy()) dfsAcquire(DfsHold::Led); // 再生中の差し替えは保持済み
+    else         addPlayed(now);
+    seq_.steps     = pattern.steps;
+    seq_.len       = pattern.len;
+    seq_.idx       = 0;
+    seq_.stepAtUs  = now;
+    seq_.startAtUs = now;
+    set(pattern.steps[0].on);
+  }
+
+  static bool busy() {
+    return seq_.steps != nullptr;
+  }
+
+  // 次にステップが切り替わるまでの時間[µs]
+  static usec_t remainingUs(usec_t now) {
+    usec_t due = seq_.stepAtUs + seq_.steps[seq_.idx].durUs;
+    return (due > now) ? (due - now) : 0;
+  }
+
+  // 経過時間に応じてステップを進める
+  static void tick(usec_t now) {
+    if (!busy()) return;
+    PROBE_SCOPE(LedTick);
+    while (now - seq_.stepAtUs >= seq_.steps[seq_.idx].durUs) {
+      seq_.stepAtUs += seq_.steps[seq_.idx].durUs;
+      if (++seq_.idx >= seq_.len) {
+        addPlayed(seq_.stepAtUs); // 最終ステップの終わり
+        seq_.steps = nullptr;
+        set(false); // 通常動作ではLED消灯を維持
+        dfsRelease(DfsHold::Led);
+        return;
+      }
+      set(seq_.steps[seq_.idx].on);
+    }
+  }
+
+  static void addPlayed(usec_t endUs) {
+    playedUs_ = playedUs_ + static_cast<uint32_t>(endUs - seq_.startAtUs);
+  }
+
+  // LEDタスク: 要求待ちとステップ切り替えのみ（制御系とは独立した低優先度）
+  static void task(void*) {
+    for (;;) {
+      TickType_t wait = portMAX_DELAY;
+      if (busy()) {
+        usec_t remain = remainingUs(nowUs());
+        wait = pdMS_TO_TICKS((remain + 999) / 1000);
+      }
+      LedPattern req;
+      if (xQueueReceive(queue_, &req, wait) == pdTRUE) {
+        start(req);
+      }
+      tick(nowUs());
+    }
+  }
+
+  static LedSequencer  seq_;
+  static QueueHandle_t queue_;
+  static TaskHandle_t  task_;
+  static volatile bool activeHigh_;
+  static volatile uint32_t playedUs_;
+};
+
+template <typename Config> LedSequencer  Led<Config>::seq_;
+template <typename Config> QueueHandle_t Led<Config>::queue_ = nullptr;
+template <typename Config> TaskHandle_t  Led<Config>::task_  = nullptr;
+template <typename Config> volatile bool Led<Config>::activeHigh_ = Config::LED_ACTIVE_HIGH;
+template <typename Config> volatile uint32_t Led<Config>::playedUs_ = 0;
@@ -0,0 +1,63 @@
+#pragma once
+#include <stdint.h>
+#include "supervisor_config.h"
+
+//==================== 電源OFF毎の時間プロファイル ====================
+// KILL解放の時点で、その電源OFFの各区間をチャネル毎に1件記録する（常時有効）。
+// 直近 PROFILE_HISTORY 件を循環で持ち、分布（最小/中央/90%/最大とlog2ヒストグラム）は
+// 問い合わせ時にこの窓から求める。KILL_MIN_HOLD_US / KILL_TIMEOUT_US を
+// ハード版毎に詰めるための実測値（シリアル 'H' でヒストグラム、'L' で記録の列）。
+// 記録はISR/タイマから killMux_ 内で数ストアのみ、集計と書式化は読み出し側。
+
+constexpr uint32_t PROFILE_HISTORY = 64; // 2のべき乗（28B×64 = 1.8KB/チャネル）
+static_assert((PROFILE_HISTORY & (PROFILE_HISTORY - 1)) == 0, "PROFILE_HISTORY must be a power of two");
+constexpr uint32_t PROFILE_NONE = UINT32_MAX; // 該当なし（解放までにRESETが落ちなかった等）
+
+// log2ヒストグラム: バケツ i は [2^(i+MIN), 2^(i+MIN+1)) µs（先頭は未満、末尾は以上も含む）
+constexpr uint8_t PROFILE_HIST_LOG2_MIN = 4;  // 16µs
+constexpr uint8_t PROFILE_HIST_BUCKETS  = 20; // 末尾 >= 2^23µs ≒ 8.4s
+
+struct PowerCycleProfile {
+  uint32_t onUs;          // RESET=H 開始→INT立下り（通電時間、アサート時に RESET=L なら PROFILE_NONE）
+  uint32_t intToKillUs;   // INT立下り（受付）→KILLアサート
+  uint32_t killToResetUs; // KILLアサート→RESET立下り（解放までに落ちなければ PROFILE_NONE）
+  uint32_t killHeldUs;    // KILLアサート→解放
+  uint32_t ledUs;         // 前回の解放からのLED再生時間（再生し終えたパターンの分）
+  uint32_t sleepUs;       // 前回の解放からのライトスリープ時間（LOW_POWER_MODE、全チャネル共通の待機）
+  uint8_t  release;       // TraceRelease
+  uint8_t  reserved[3];
+};
+static_assert(sizeof(PowerCycleProfile) == 28, "PowerCycleProfile layout");
+
+struct PowerProfileLog {
+  uint32_t          written; // 記録総数（次の書き込み位置 = written % PROFILE_HISTORY）
+  PowerCycleProfile records[PROFILE_HISTORY];
+};
+
+// ライトスリープの累計[µs]（書き手は監視タスクのみ、u32の差分で読むので一周は問題ない）
+extern volatile uint32_t g_profileSleepUs;
+
+inline void profileNoteSleep(uint32_t us) {
+  g_profileSleepUs = g_profileSleepUs + us;
+}
+
+// 1件追加（呼び出し側のロック内で）
+inline void IRAM_ATTR profilePush(PowerProfileLog& log, const PowerCycleProfile& p) {
+  log.records[log.written & (PROFILE_HISTORY - 1)] = p;
+  log.written = log.written + 1;
+}
+
+// 区間の長さを u32 に丸める（負は0、超過は PROFILE_NONE 未満で飽和）
+inline uint32_t IRAM_ATTR profileSpan(int64_t fromUs, int64_t toUs) {
+  const int64_t d = toUs - fromUs;
+  if (d <= 0) return 0;
+  return d >= static_cast<int64_t>(PROFILE_NONE) ? PROFILE_NONE - 1 : static_cast<uint32_t>(d);
+}
+
+// 窓の集計をテキストで出力（records は古い順に count 件、total はこれまでの記録総数）
+//   "profile ch=N cycles=.. window=.. rel_reset=.. rel_hold=.. rel_timeout=.. rel_backstop=.."
+//   区間毎に "profile ch=N m=<区間> n=.. min=.. p50=.. p90=.. max=.. hist=c0,c1,..."（µs）
+void profileReport(Print& out, uint8_t channel, const PowerCycleProfile* records, uint32_t count, uint32_t total);
+// 記録を1件1行で出力（index はこれまでの通番、PROFILE_NONE は "none"）
+void profilePrintRecords(Print& out, uint8_t channel, const PowerCycleProfile* records, uint32_t count,
+                         uint32_t total);
@@ -0,0 +1,77 @@
+#pragma once
+#include <stdint.h>
+#include "supervisor_config.h"
+#if !SUPERVISOR_NATIVE
+  #include <esp_attr.h>
+  #include <esp_cpu.h>
+#endif
+
+//==================== ホットパスの計測プローブ ====================
+// 1: PROBE_SCOPE(名前) を置いた区間のCPUサイクル数を、プローブ毎に回数/最小/最大/合計で集計する
+//    （確保・書式化なし。記録はコア毎のバケツへ割り込みマスク下で数ストア）。シリアル 'R' で出力
+// サイクル数は区間の入口と出口のコアの CCOUNT の差で、SUPERVISOR_DFS では周波数により意味が変わる
+#ifndef SUPERVISOR_PROBES
+  #define SUPERVISOR_PROBES 0
+#endif
+
+enum class ProbeId : uint8_t {
+  GpioIsr = 0,  // 共通GPIO割り込み全体（EDGE_CAPTURE_MCPWM ではキャプチャ割り込み）
+  IntFalling,   // INT立下りの判定（recordIntFalling）
+  ResetEdge,    // RESETエッジの刻印とRESET立下りでのKILL解放判定
+  KillRelease,  // KILL解放（ISR / タイマ / フェイルセーフ）
+  HandleEvents, // 監視タスクのイベント処理
+  LedTick,      // LEDシーケンサの1ステップ
+  Backstop,     // フェイルセーフの点検割り込み
+  Loop,         // Arduinoの loop() 1回（シリアルコマンド）
+  Count,
+};
+
+constexpr uint8_t PROBE_CORES = 2;
+
+struct ProbeBucket {
+  uint32_t count;
+  uint32_t minCycles; // count==0 なら無効
+  uint32_t maxCycles;
+  uint64_t sumCycles;
+};
+
+// ホスト実行（SUPERVISOR_NATIVE）では計測しない
+#if !SUPERVISOR_NATIVE
+extern ProbeBucket g_probes[PROBE_CORES][static_cast<size_t>(ProbeId::Count)];
+
+// 1件の記録（ISRからも可。同じコアの割り込みと入れ違わないよう一瞬だけマスク）
+inline void IRAM_ATTR probeRecord(ProbeId id, uint32_t cycles) {
+  const uint32_t irq = portSET_INTERRUPT_MASK_FROM_ISR();
+  ProbeBucket& b = g_probes[xPortGetCoreID()][static_cast<size_t>(id)];
+  if (b.count == 0 || cycles < b.minCycles) b.minCycles = cycles;
+  if (cycles > b.maxCycles) b.maxCycles = cycles;
+  b.sumCycles += cycles;
+  ++b.count;
+  portCLEAR_INTERRUPT_MASK_FROM_ISR(irq);
+}
+
+// 区間の入口で CCOUNT を読み、出口で記録する
+class ProbeScope {
+ public:
+  inline __attribute__((always_inline)) explicit ProbeScope(ProbeId id)
+      : id_(id), start_(esp_cpu_get_ccount()) {}
+  inline __attribute__((always_inline)) ~ProbeScope() {
+    probeRecord(id_, esp_cpu_get_ccount() - start_);
+  }
+
+ private:
+  ProbeId  id_;
+  uint32_t start_;
+};
+
+#endif
+
+#if SUPERVISOR_PROBES && !SUPERVISOR_NATIVE
+  #define PROBE_SCOPE(name) ProbeScope probeScope_(ProbeId::name)
+#else
+  #define PROBE_SCOPE(name) do {} while (0)
+#endif
+
+// 全プローブをコアの区別なく1行ずつ出力（"probe name n=.. min=.. avg=.. max=.. cyc"、未記録は省略）
+void probeReport(Print& out);
+void probeClear();
@@ -0,0 +1,22 @@
+#pragma once
+#include <stdint.h>
+
+//==================== 波形リプレイ（実機） ====================
+// 1: シリアルで流し込まれたエッジ列（replay_format.h）を予備GPIOから PIN_RESET / PIN_INT へ
+//    ループバック駆動し、INT立下り毎にKILLの有無とレイテンシをシリアルへ出力する
+//    （入力はクレジット制で少しずつ受け取り、全体は保持しない。送出は scripts/replay_send.py）
+#ifndef SUPERVISOR_REPLAY
+  #define SUPERVISOR_REPLAY 0
+#endif
+
+// 配線は SUPERVISOR_BENCH と同じ: drvReset -> PIN_RESET, drvInt -> PIN_INT
+struct ReplayConfig {
+  int      pinKill;
+  bool     killActiveLow;
+  int      drvReset;
+  int      drvInt;
+  uint32_t killWindowUs;  // INT立下りからKILLを待つ上限（次のエッジが先ならそこまで）
+};
+
+// リプレイタスクを起動（監視タスクとは別コア、シリアル入力はこのタスクが専有）
+void replayBegin(const ReplayConfig& cfg);
@@ -0,0 +1,67 @@
+#pragma once
+#include <stdint.h>
+
+//==================== 波形リプレイの入力形式 ====================
+// ロジアナ等で取った RESET/INT の波形をエッジ列にしたもの（リトルエンディアン）
+//   ヘッダ: u32 magic（送出順に "RPL1"）
+//   記録  : u32 deltaUs（前の記録から、先頭はリプレイ開始から） | u8 signal | u8 level  の6バイト
+// 先頭から順に読むだけなので、全体を保持せずに流し込める（長時間の記録もそのまま使える）。
+// 間隔が u32 を超える時は signal=Gap の記録で時間だけ進める。
+// 変換は scripts/replay_send.py（CSV→バイナリ、実機への送出）。
+
+constexpr uint32_t REPLAY_MAGIC       = 0x314C5052; // 送出順に "RPL1"
+constexpr uint32_t REPLAY_RECORD_SIZE = 6;
+
+enum class ReplaySignal : uint8_t {
+  Reset = 0,
+  Int   = 1,
+  Gap   = 0xFF, // エッジなし（deltaUs だけ進める）
+};
+
+struct ReplayEdge {
+  uint32_t     deltaUs;
+  ReplaySignal signal;
+  bool         high;
+};
+
+// 1バイトずつ渡して記録を取り出す（ヘッダ不一致・未知の signal 以降は error()）
+class ReplayDecoder {
+ public:
+  // 記録が揃ったら true を返して out に入れる
+  bool push(uint8_t b, ReplayEdge& out) {
+    if (error_) return false;
+    buf_[len_++] = b;
+    if (!headerDone_) {
+      if (len_ < 4) return false;
+      headerDone_ = true;
+      len_ = 0;
+      error_ = (le32(buf_) != REPLAY_MAGIC);
+      return false;
+    }
+    if (len_ < REPLAY_RECORD_SIZE) return false;
+    len_ = 0;
+    const uint8_t signal = buf_[4];
+    if (signal != static_cast<uint8_t>(ReplaySignal::Reset) &&
+        signal != static_cast<uint8_t>(ReplaySignal::Int) &&
+        signal != static_cast<uint8_t>(ReplaySignal::Gap)) {
+      error_ = true;
+      return false;
+    }
+    out.deltaUs = le32(buf_);
+    out.signal  = static_cast<ReplaySignal>(signal);
+    out.high    = buf_[5] != 0;
+    return true;
+  }
+
+  bool error() const { return error_; }
+
+ private:
+  static uint32_t le32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+  }
+
+  uint8_t  buf_[REPLAY_RECORD_SIZE] = {};
+  uint32_t len_ = 0;
+  bool     headerDone_ = false;
+  bool     error_ = false;
+};
@@ -0,0 +1,55 @@
+#pragma once
+#include <stdint.h>
+
+//==================== 単一生産者・単一消費者リング ====================
+// ISR（生産者）→タスク（消費者）の受け渡し用。ロックも割り込み禁止も使わない。
+// head は生産者だけ、tail は消費者だけが書く。要素を書き終えてから head を進めて公開する
+// （Xtensa の GCC は volatile アクセスに memw を付けるのでコア間でも順序が保たれる）。
+// ISRから呼ぶ push() は always_inline で呼び出し元（IRAM_ATTR）へ展開させる。
+#define SPSC_RING_INLINE inline __attribute__((always_inline))
+
+template <typename T, uint32_t N>
+class SpscRing {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+ public:
+  // 生産者側: 満杯なら捨てて dropped を数える
+  SPSC_RING_INLINE bool push(const T& value) {
+    uint32_t head = head_;
+    uint32_t next = (head + 1) & (N - 1);
+    if (next == tail_) {
+      dropped_ = dropped_ + 1;
+      return false;
+    }
+    buf_[head] = value;
+    __asm__ __volatile__("" ::: "memory"); // 要素の書き込みを head 公開より前に
+    head_ = next;
+    return true;
+  }
+
+  // 消費者側: 取り出せたら true
+  SPSC_RING_INLINE bool pop(T& out) {
+    uint32_t tail = tail_;
+    if (tail == head_) return false;
+    __asm__ __volatile__("" ::: "memory");
+    out = buf_[tail];
+    __asm__ __volatile__("" ::: "memory"); // 読み終えてから枠を返す
+    tail_ = (tail + 1) & (N - 1);
+    return true;
+  }
+
+  SPSC_RING_INLINE bool empty() const {
+    return head_ == tail_;
+  }
+
+  // 満杯で捨てた累計（消費者側で前回値と比べて取りこぼしを検出する）
+  SPSC_RING_INLINE uint32_t dropped() const {
+    return dropped_;
+  }
+
+ private:
+  T                 buf_[N];
+  volatile uint32_t head_ = 0;
+  volatile uint32_t tail_ = 0;
+  volatile uint32_t dropped_ = 0;
+};
@@ -0,0 +1,159 @@
+#pragma once
+#include <stdint.h>
+#include <Arduino.h>
+#include <soc/gpio_struct.h>
+#include <driver/gpio.h>
+#include <esp_ipc.h>
+#include <esp_intr_alloc.h>
+#include "supervisor_config.h"
+#include "supervisor_core.h"
+#include "supervisor_platform.h"
+#include "failsafe.h"
+#include "probe.h"
+
+// 共通GPIO割り込みの確保フラグ（SUPERVISOR_COEX では無線の割り込みより上のレベル3）
+// レベル3まではFreeRTOSのFromISR APIとスピンロックを使える
+constexpr int SUPERVISOR_INTR_FLAGS = ESP_INTR_FLAG_IRAM | (SUPERVISOR_COEX ? ESP_INTR_FLAG_LEVEL3 : 0);
+
+// 実機の1チャネル分の監視（状態機械は supervisor_core.h、ハード依存部は supervisor_platform.h）
+template <typename Config>
+using Supervisor = SupervisorCore<Config, EspSupervisorPlatform<Config>>;
+
+//==================== 複数チャネルの束ね ====================
+// Supervisor<Config> を並べて同じ監視タスク・同じGPIO割り込みで動かす
+#define SUPERVISOR_FOR_EACH(expr) \
+  do { using swallow_ = int[]; (void)swallow_{0, ((expr), 0)...}; } while (0)
+
+// 全チャネルの INT/RESET ビットの和（重複するピンはコンパイルエラー）
+template <typename... Channels>
+struct SupervisorPinMask {
+  static constexpr uint32_t value = 0;
+};
+template <typename First, typename... Rest>
+struct SupervisorPinMask<First, Rest...> {
+  static_assert((First::WAKE_PINS_MASK & SupervisorPinMask<Rest...>::value) == 0,
+                "INT/RESET pins must not be shared between channels");
+  static constexpr uint32_t value = First::WAKE_PINS_MASK | SupervisorPinMask<Rest...>::value;
+};
+
+template <typename... Channels>
+struct SupervisorSet {
+  static constexpr size_t   COUNT    = sizeof...(Channels);
+  static constexpr uint32_t PIN_MASK = SupervisorPinMask<Channels...>::value;
+#if EDGE_CAPTURE_MCPWM
+  static_assert(COUNT == 1, "EDGE_CAPTURE_MCPWM supports a single channel (MCPWM_UNIT_0 CAP0/CAP1)");
+#endif
+
+  // 静的初期化（SUPERVISOR_FAST_BOOT）から: 全チャネルのKILLをアイドルへ（レジスタ書き込みのみ）
+  static void killIdleEarly() { SUPERVISOR_FOR_EACH(Channels::killIdleEarly()); }
+  // 同じく: 全チャネルのINT立下りの計数（PCNT）を開始
+  static void intCountEarly() { SUPERVISOR_FOR_EACH(Channels::intCountEarly()); }
+
+  // ドライバを使う構成（PCNT・RTCメモリの記録・pinMode）は begin() から、RTOS起動後に
+  static void pinsBegin() {
+    bootCaptureBegin();
+    failsafeBegin();
+    SUPERVISOR_FOR_EACH(Channels::pinsBegin());
+  }
+  static void begin(BaseType_t ledCore) {
+    pinsBegin();
+    SUPERVISOR_FOR_EACH(Channels::begin(ledCore));
+  }
+
+  // 共通GPIO割り込みを core（監視タスクと同じコア）に確保してから各チャネルのピン割り込みを有効化
+  // gpio_isr_register はGPIO割り込みを専有するので、attachInterrupt / ISRサービスとは併用しない
+  // （EDGE_CAPTURE_MCPWM のキャプチャ割り込みは呼び出したコアに確保される）
+  static void arm(BaseType_t core) {
+#if !EDGE_CAPTURE_MCPWM
+    if (xPortGetCoreID() == core) isrRegister(nullptr);
+    else ESP_ERROR_CHECK(esp_ipc_call_blocking(core, isrRegister, nullptr));
+#else
+    (void)core;
+#endif
+    SUPERVISOR_FOR_EACH(Channels::arm());
+  }
+
+  // 割り込みは確保したコアへルーティングされる
+  static void isrRegister(void*) {
+    gpio_isr_handle_t handle = nullptr;
+    ESP_ERROR_CHECK(gpio_isr_register(onGpioInterrupt, nullptr, SUPERVISOR_INTR_FLAGS, &handle));
+  }
+
+  // 共通GPIO割り込み: ステータスと入力レベルを1回ずつ読み、全チャネルを1パスで判定
+  // （チャネル数が増えてもエッジあたりの入口コストは一定、通知もまとめて1回）
+  static void IRAM_ATTR onGpioInterrupt(void*) {
+    PROBE_SCOPE(GpioIsr);
+    const uint32_t raw = GPIO.status;
+    GPIO.status_w1tc = raw; // 割り込みを専有しているので担当外のビットも落とす
+    const uint32_t status = raw & PIN_MASK;
+    const uint32_t in  = GPIO.in;
+    const usec_t   now = nowUs();
+    bool notify = false;
+    SUPERVISOR_FOR_EACH(notify = Channels::onGpioBatch(now, status, in) || notify);
+    if (notify) notifySupervisorFromIsr(NOTIFY_EVENT);
+  }
+  // フェイルセーフの点検（ハードウェアタイマ割り込み、failsafeBackstopBegin() へ渡す）
+  static bool IRAM_ATTR onBackstop(void*) {
+    PROBE_SCOPE(Backstop);
+    const usec_t now = nowUs();
+    SUPERVISOR_FOR_EACH(Channels::backstopCheck(now));
+    return false;
+  }
+  static void IRAM_ATTR forceKillIdle() { SUPERVISOR_FOR_EACH(Channels::forceKillIdle()); }
+
+  static void handleEvents()            { SUPERVISOR_FOR_EACH(Channels::handleEvents()); }
+  static void clearStats()              { SUPERVISOR_FOR_EACH(Channels::clearStats()); }
+
+  // チャネル番号で実行時設定を読み書き（該当チャネルが無い・範囲外なら false）
+  static bool tuning(uint8_t channel, SupervisorTuning& out) {
+    bool found = false;
+    SUPERVISOR_FOR_EACH(found = (Channels::CHANNEL == channel ? (out = Channels::tuning(), true) : false) || found);
+    return found;
+  }
+  static bool setTuning(uint8_t channel, const SupervisorTuning& t) {
+    bool ok = false;
+    SUPERVISOR_FOR_EACH(ok = (Channels::CHANNEL == channel && Channels::setTuning(t)) || ok);
+    return ok;
+  }
+  static void resetTuning() { SUPERVISOR_FOR_EACH(Channels::resetTuning()); }
+
+  static bool idle() {
+    bool all = true;
+    SUPERVISOR_FOR_EACH(all = Channels::idle() && all);
+    return all;
+  }
+
+  static bool anyKillActive() {
+    bool any = false;
+    SUPERVISOR_FOR_EACH(any = Channels::killActive() || any);
+    return any;
+  }
+
+  // チャネル番号で電源OFF毎のプロファイルを取り出す（out は PROFILE_HISTORY 要素、該当チャネルが無ければ false）
+  static bool profile(uint8_t channel, PowerCycleProfile* out, uint32_t& count, uint32_t& total) {
+    bool found = false;
+    SUPERVISOR_FOR_EACH(found = (Channels::CHANNEL == channel ? (count = Channels::profile(out, total), true) : false) || found);
+    return found;
+  }
+
+  // チャネル順に統計を取り出す（out は COUNT 要素）
+  static void stats(SupervisorStats* out) {
+    SupervisorStats* p = out;
+    SUPERVISOR_FOR_EACH(*p++ = Channels::stats());
+  }
+
+  static bool anyIntLow() {
+    bool any = false;
+    SUPERVISOR_FOR_EACH(any = Channels::intLow() || any);
+    return any;
+  }
+  static void sleepPrepare() { SUPERVISOR_FOR_EACH(Channels::sleepPrepare()); }
+  static void sleepRestore() { SUPERVISOR_FOR_EACH(Channels::sleepRestore()); }
+  static void sleepResume()  { SUPERVISOR_FOR_EACH(Channels::sleepResume()); }
+  // いずれかのチャネルでINT立下りを受け付けたら true
+  static bool sleepSynthesize(usec_t wakeAt) {
+    bool any = false;
+    SUPERVISOR_FOR_EACH(any = Channels::sleepSynthesize(wakeAt) || any);
+    return any;
+  }
+};
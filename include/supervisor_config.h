@@ -0,0 +1,102 @@
+#pragma once
+#include <stdint.h>
+
+//==================== ビルド設定 ====================
+// 1: ホスト実行のシミュレーション（env:native）。判定ロジックと Config だけを使い、時刻は仮想時計
+#ifndef SUPERVISOR_NATIVE
+  #define SUPERVISOR_NATIVE 0
+#endif
+#if !SUPERVISOR_NATIVE
+  #include <Arduino.h>
+  #include <esp_timer.h>
+  #include <soc/gpio_struct.h>
+#else
+  // ホストでは配置指定は意味を持たない
+  #ifndef IRAM_ATTR
+    #define IRAM_ATTR
+  #endif
+  class Print; // 出力関数の宣言用（ホストでは定義しない）
+#endif
+
+// 1: INT ISR内でKILLを直接アサート（レジスタ直書き、監視タスクは解放のみ担当）
+#ifndef KILL_ASSERT_IN_ISR
+  #define KILL_ASSERT_IN_ISR 0
+#endif
+// 1: 保留中の処理が無い間はライトスリープ（INT/RESETのGPIOレベルで起床）
+#ifndef LOW_POWER_MODE
+  #define LOW_POWER_MODE 0
+#endif
+// 1: INT/RESET をMCPWMキャプチャへ通し、エッジ時刻をハードウェアで刻印
+#ifndef EDGE_CAPTURE_MCPWM
+  #define EDGE_CAPTURE_MCPWM 0
+#endif
+// 1: INTの最初の立下りで割り込みを止め、一定周期のサンプリングでLが安定してから判定する
+//    （チャタリング毎の割り込みが無くなり、グリッチは判定前に落ちる。判定は安定幅だけ遅れる）
+#ifndef INT_FILTER_SAMPLED
+  #define INT_FILTER_SAMPLED 0
+#endif
+// 1: Wi-Fi/BLE と同居する構成。共通GPIO割り込みをレベル3（Cハンドラの最上位、無線のレベル1より上）で
+//    確保する（監視コアへの固定は常に行う）。無線・Arduinoイベントタスクは core 0 に置く（platformio の env 参照）
+//    無線負荷下の INT→KILL がこれで抑えられるかは未検証（手順と結果の表は docs/measurements.md）
+#ifndef SUPERVISOR_COEX
+  #define SUPERVISOR_COEX 0
+#endif
+#if EDGE_CAPTURE_MCPWM && INT_FILTER_SAMPLED
+  #error "INT_FILTER_SAMPLED works on the GPIO interrupt path; it cannot be combined with EDGE_CAPTURE_MCPWM"
+#endif
+#if EDGE_CAPTURE_MCPWM && SUPERVISOR_NATIVE
+  #error "EDGE_CAPTURE_MCPWM uses the MCPWM driver and cannot be built for the host"
+#endif
+#if EDGE_CAPTURE_MCPWM && LOW_POWER_MODE
+  #error "EDGE_CAPTURE_MCPWM cannot be combined with LOW_POWER_MODE (edges during light sleep are synthesized in software)"
+#endif
+
+// 計測環境では起動抑止を短くして疑似操作の待ちを減らす
+#ifndef STARTUP_INHIBIT_MAX_MS
+  #define STARTUP_INHIBIT_MAX_MS 1000
+#endif
+
+//==================== 時間 ====================
+// 時刻はすべて esp_timer の64bit µs（起動からの経過、実質ラップなし）
+using usec_t = int64_t;
+
+// ISR経路（onGpioInterrupt / onEdgeCapture から呼ばれるもの）はすべて
+// IRAM_ATTR にし、フラッシュキャッシュ無効中（OTA書き込み・NVSコミット等）でも動くようにする。
+// 参照する変数は .data/.bss（DRAM）のみ、定数は constexpr の即値のみとする。
+// 配置はビルド後に scripts/check_isr_iram.py がELFを走査して検証する。
+
+#if !SUPERVISOR_NATIVE
+// 現在時刻[µs]（esp_timer_get_time はIRAM常駐、ISRからも呼べる）
+inline usec_t IRAM_ATTR nowUs() {
+  return esp_timer_get_time();
+}
+#endif
+
+//==================== チャネル設定 ====================
+// Supervisor<Config> の Config はこれを継承し、ピンと変えたい値だけを定義し直す:
+//   CHANNEL   : チャネル番号（0〜15、トレース/統計の識別）
+//   PIN_RESET : TPS3424 -> MCU (Active HIGH, push-pull)
+//   PIN_INT   : TPS3424 -> MCU (Active LOW, open-drain)
+//   PIN_KILL  : MCU -> TPS3424
+struct SupervisorDefaults {
+  // 表示LED（-1: なし）。ボードによりHIGH/LOW極性が異なるので定数で吸収
+  static constexpr int    PIN_LED         = -1;
+  static constexpr bool   LED_ACTIVE_HIGH = false;
+  // KILLの極性（アイドルはHi-Z＋非アクティブ側へのプル）
+  static constexpr bool   KILL_ACTIVE_LOW = true;
+
+  // INT直後の「KILL無視窓」を超えるための最低保持
+  static constexpr usec_t KILL_MIN_HOLD_US = 10000;
+  // 念のための上限（RESETがLOWにならなくても解放）
+  static constexpr usec_t KILL_TIMEOUT_US  = 1000000;
+  // INT入力のチャタリング抑制
+  static constexpr usec_t INT_DEBOUNCE_US  = 10000;
+  // 「RESETがHになってからこの時間以上継続している時だけKILLする」
+  static constexpr usec_t RESET_HIGH_MIN_US_BEFORE_INT = 10000; // 環境で50〜150ms程度を調整
+  // 起動時のKILL抑止の上限
+  static constexpr usec_t STARTUP_INHIBIT_MAX_US = STARTUP_INHIBIT_MAX_MS * 1000LL;
+  // INT_FILTER_SAMPLED: サンプリング周期と、L/Hが安定したとみなす幅の初期値（幅は実行中に変更可）
+  static constexpr usec_t INT_FILTER_SAMPLE_US = 250;
+  static constexpr usec_t INT_FILTER_US        = 2000;
+  static constexpr usec_t INT_FILTER_MAX_US    = 100000;
+};
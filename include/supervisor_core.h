@@ -0,0 +1,796 @@
+#pragma once
+#include <stdint.h>
+#include "supervisor_config.h"
+#include "spsc_ring.h"
+#include "supervisor_event.h"
+#include "supervisor_logic.h"
+#include "supervisor_tuning.h"
+#include "trace_log.h"
+#include "supervisor_stats.h"
+#include "power_profile.h"
+#include "failsafe.h"
+#include "probe.h"
+#if EDGE_CAPTURE_MCPWM
+  #include <driver/mcpwm.h>
+  #include <soc/soc.h>
+#endif
+
+//==================== ハード依存部の差し替え（Platform） ====================
+// SupervisorCore<Config, Platform> は状態機械だけを持ち、時計・ピン・タイマ・割り込み制御と
+// 記録先（トレース・起動捕捉・周波数・フェイルセーフ・LED）はすべて Platform の静的関数を通す。
+// 実機は EspSupervisorPlatform<Config>（supervisor_platform.h）、ホスト実行は
+// HostSupervisorPlatform<Config>（supervisor_host.h）。ISR経路から呼ぶものは
+// 呼び出し元（IRAM_ATTR）へ展開されるよう always_inline で実装する。
+//   時計     : now()
+//   ピン     : ResetPin / IntPin（high() low() MASK）、KillPin（set() clear() drive() release() padPull()）
+//              pinsInit()（RESET/INT入力、KILLは Hi-Z ＋非アクティブ側プル）
+//              resetIrqEnable() / intIrqEnable()（両エッジ / 立下り）、intIrq(PinIrq)、intStatusClear()
+//   排他     : Lock（定数初期化できる型）、lock() / unlock()（ISRからも可）、interruptsOff() / interruptsOn()
+//   タイマ   : Timer（ポインタ型）、timerCreate(cb, name)、timerStartOnce / timerStartPeriodic / timerStop
+//              （起動中への start は何もしない、止まっているものへの stop も何もしない）
+//   記録     : trace()、bootResetEdge() / bootResetHighSince() / bootIntBegin() / bootIntTake()、
+//              killBoost()、failsafeNote()、sleptUs()、notifyFromIsr()
+//   LED      : ledPinBegin() / ledBegin() / ledPowerOn() / ledPowerOff() / ledIdle() / ledPlayedUs() / ledActiveHigh()
+//   ライトスリープ（LOW_POWER_MODE のみ）: sleepPrepare(resetHigh) / sleepRestore() / sleepResume()
+
+// INTのピン割り込み種別（INT_FILTER_SAMPLED の切り替え用）
+enum class PinIrq : uint8_t {
+  Disabled = 0,
+  Falling,
+  LowLevel,
+};
+
+// イベントリング長（チャネル毎、2のべき乗）
+constexpr uint32_t EVENT_RING_LEN = 32;
+
+//==================== 1チャネル分の監視 ====================
+// 状態はすべて静的メンバ（チャネル毎に別の実体）。ピン・極性は Config の定数なので
+// ISR経路はチャネル毎に即値へ畳み込まれ、引数や分岐なしのレジスタ操作になる。
+// 時間パラメータは Config を初期値に tuning_ から読む（setTuning() で実行中に変更可）。
+//   ISR       : onGpioBatch（/ onEdgeCapture）がエッジを刻印・判定してリングへ
+//   監視タスク: handleEvents() がLED表示・起動抑止・（ISRアサートでなければ）KILLを実行
+//   タイマ    : KILLの最低保持/タイムアウト、起動抑止の上限
+//   HWタイマ  : backstopCheck() がタスク・タイマが止まった時の強制解放/アサート（failsafe.h）
+template <typename Config, typename Platform>
+class SupervisorCore {
+  static_assert(Config::CHANNEL < 16, "CHANNEL must fit in the trace code nibble");
+  static_assert(Config::KILL_MIN_HOLD_US < Config::KILL_TIMEOUT_US &&
+                Config::KILL_TIMEOUT_US <= TUNING_KILL_TIMEOUT_MAX_US &&
+                Config::INT_DEBOUNCE_US <= TUNING_DEBOUNCE_MAX_US &&
+                Config::RESET_HIGH_MIN_US_BEFORE_INT <= TUNING_RESET_HIGH_MAX_US &&
+                Config::STARTUP_INHIBIT_MAX_US <= TUNING_STARTUP_INHIBIT_MAX_US,
+                "Config timing defaults must be accepted by setTuning()");
+
+  using P        = Platform;
+  using ResetPin = typename P::ResetPin;
+  using IntPin   = typename P::IntPin;
+  using KillPin  = typename P::KillPin;
+  using Timer    = typename P::Timer;
+  using Lock     = typename P::Lock;
+  using Logic    = SupervisorLogic<Config>;
+
+ public:
+  static constexpr uint8_t  CHANNEL        = Config::CHANNEL;
+  static constexpr uint32_t RESET_MASK     = ResetPin::MASK;
+  static constexpr uint32_t INT_MASK       = IntPin::MASK;
+  static constexpr uint32_t WAKE_PINS_MASK = INT_MASK | RESET_MASK; // 割り込みステータスの担当ビット
+
+  // 静的初期化（SUPERVISOR_FAST_BOOT）用: KILLをアイドルに固定するレジスタ書き込みのみ
+  // （ドライバ・Arduino HAL・ログ・ヒープは使わない。正式な構成は setup() の pinsBegin()）
+  static void killIdleEarly() {
+    killLatch();
+    KillPin::release();
+    KillPin::padPull(Config::KILL_ACTIVE_LOW);
+  }
+
+  // 静的初期化（SUPERVISOR_FAST_BOOT）用: INT立下りの計数をここから始める（レジスタ書き込みのみ、
+  // pinsBegin() は計数を続ける）
+  static void intCountEarly() { P::bootIntBegin(); }
+
+  // ピンのみ構成（起動時は確実にKILL非アクティブ）
+  // 1回だけ呼ぶ（bootCaptureBegin() の後）。ここから arm() までのエッジも捕捉する
+  static void pinsBegin() {
+    P::pinsInit();      // RESET: TPS3424のpush-pull出力、INT: OD想定でプルアップ、KILL: Hi-Z
+    P::ledPinBegin();
+    killLatch();
+
+    // RESET=H の起点: MCUだけの再起動で前回の起動から続いていれば記録済みの開始時刻、無ければ今
+    usec_t since = 0;
+    if (!ResetPin::high()) {
+      P::bootResetEdge(0, false);
+    } else if (P::bootResetHighSince(since)) {
+      resetCarried_ = true;
+    } else {
+      P::bootResetEdge(P::now(), true);
+    }
+    P::bootIntBegin();
+  }
+
+  // タイマ・LEDの準備（pinsBegin() の後）
+  static void begin(int ledCore) {
+    killHoldTimer_       = P::timerCreate(onKillHoldElapsed,       "kill_hold");
+    killTimeoutTimer_    = P::timerCreate(onKillTimeout,           "kill_timeout");
+    startupInhibitTimer_ = P::timerCreate(onStartupInhibitTimeout, "startup_inhibit");
+#if INT_FILTER_SAMPLED
+    intSampleTimer_      = P::timerCreate(onIntSample,             "int_sample");
+#endif
+    P::ledBegin(ledCore);
+  }
+
+  // 初期状態を取得して割り込みを有効化（共通のGPIO割り込みハンドラ登録後）
+  static void arm() {
+    // 初期状態の取得とRESET割り込み登録の間にエッジが割り込まないようにする
+    P::interruptsOff();
+    lastReset_ = ResetPin::high();
+    usec_t since = 0;
+    if (!lastReset_) {
+      resetCarried_ = false;
+      P::bootResetEdge(0, false);
+    } else if (!P::bootResetHighSince(since)) {
+      since = P::now();                         // pinsBegin() 時点ではLだった
+      P::bootResetEdge(since, true);
+    }
+    // pinsBegin() から H のままなら記録済みの起点（前回の起動からなら負の時刻もあり得る、0はL扱いなので避ける）
+    resetHighSinceUs_ = lastReset_ ? (since != 0 ? since : -1) : 0;
+#if !EDGE_CAPTURE_MCPWM
+    P::resetIrqEnable();
+#endif
+    P::interruptsOn();
+#if EDGE_CAPTURE_MCPWM
+    // キャプチャ登録は割り込み確保を伴うので禁止区間の外で行い、
+    // その間のRESET変化は監視タスク起動時の再同期に任せる
+    captureBegin();
+    if (ResetPin::high() != lastReset_) resetResyncRequest_ = true;
+#endif
+
+    // 起動時にすでにRESET=Hなら起動点滅を実行（A案）。抑止はRESET=H の起点から数える
+    // MCUだけの再起動（前回の起動から RESET=H 継続）では点滅せず、抑止も残り時間だけ
+    if (lastReset_) {
+      if (resetCarried_) startStartupInhibit(resetHighSinceUs_);
+      else               startPowerOnSequence(resetHighSinceUs_);
+    }
+
+#if !EDGE_CAPTURE_MCPWM
+    P::intIrqEnable();
+#endif
+    // 割り込み有効化までにPCNTが数えたINT立下りは、今の時刻の1エッジとして判定
+    // （有効化直後の同じエッジを両方で拾ってもデバウンスで1回になる）
+    if (P::bootIntTake() > 0) {
+#if INT_FILTER_SAMPLED
+      if (IntPin::low()) intFilterBegin(P::now()); // 離されていればグリッチ扱い
+#else
+      P::interruptsOff();
+      recordIntFalling(P::now());
+      P::interruptsOn();
+#endif
+    }
+  }
+
+  //==================== 割り込み（RESET両エッジ / INT立下り） ====================
+  // 共通ハンドラが1回読んだ GPIO.status / GPIO.in からこのチャネルの分を処理
+  // （同時に保留していればRESETを先に。監視タスクを起こすべきなら true）
+  static inline bool IRAM_ATTR onGpioBatch(usec_t now, uint32_t status, uint32_t in) {
+    bool notify = false;
+    if (status & RESET_MASK) {
+      recordResetEdge(now, (in & RESET_MASK) != 0);
+      notify = true;
+    }
+    if (status & INT_MASK) {
+#if INT_FILTER_SAMPLED
+      notify = onIntFilterIrq(now) || notify;
+#else
+      notify = recordIntFalling(now) || notify;
+#endif
+    }
+    return notify;
+  }
+
+  //==================== 監視タスク側 ====================
+  // 溜まったイベントを時系列順にまとめて処理（割り込み禁止区間なし）
+  static void handleEvents() {
+    PROBE_SCOPE(HandleEvents);
+    SupervisorEvent ev;
+    while (events_.pop(ev)) {
+      switch (ev.type) {
+        case EventType::IntFall:   handleIntFall(ev);   break;
+        case EventType::ResetRise:
+        case EventType::ResetFall: handleResetEdge(ev); break;
+      }
+    }
+#if !KILL_ASSERT_IN_ISR
+    // リング満杯で捨てたKILL判定（処理済みなら0）
+    const usec_t requestAt = killRequestAtUs();
+    if (requestAt != 0) killBegin(P::now(), requestAt);
+#endif
+    uint32_t dropped = events_.dropped();
+    if (dropped != eventsDroppedSeen_ || resetResyncRequest_) {
+      eventsDroppedSeen_  = dropped;
+      resetResyncRequest_ = false;
+      resyncResetLevel();
+    }
+  }
+
+  static bool killActive() {
+    return killActive_;
+  }
+
+  // KILL/抑止/INT安定待ち/LED/未処理イベントのいずれも無い
+  static bool idle() {
+#if INT_FILTER_SAMPLED
+    if (intFiltering_) return false;
+#endif
+    return !killActive_ && !startupInhibit_ && events_.empty() && P::ledIdle();
+  }
+
+  static SupervisorStats stats() {
+    SupervisorStats s = statsSnapshot(stats_);
+    s.eventsDropped = events_.dropped();
+    return s;
+  }
+
+  static void clearStats() {
+    statsClear(stats_);
+    P::lock(killMux_);
+    profile_.written    = 0;
+    profileLedSeenUs_   = P::ledPlayedUs(); // 次の記録は消去の時点から数える
+    profileSleepSeenUs_ = P::sleptUs();
+    P::unlock(killMux_);
+  }
+
+  // 電源OFF毎のプロファイルを古い順に out へ（out は PROFILE_HISTORY 要素、件数を返す）
+  // 1件ずつ killMux_ 内で写し（KILL経路を止めるのは1件のコピーの間だけ）、
+  // 写している間に記録が増えていたら窓が新旧混ざるので取り直す
+  static uint32_t profile(PowerCycleProfile* out, uint32_t& total) {
+    for (;;) {
+      P::lock(killMux_);
+      total = profile_.written;
+      P::unlock(killMux_);
+      const uint32_t count = total < PROFILE_HISTORY ? total : PROFILE_HISTORY;
+      for (uint32_t i = 0; i < count; ++i) {
+        P::lock(killMux_);
+        out[i] = profile_.records[(total - count + i) & (PROFILE_HISTORY - 1)];
+        P::unlock(killMux_);
+      }
+      P::lock(killMux_);
+      const bool unchanged = (profile_.written == total);
+      P::unlock(killMux_);
+      if (unchanged) return count; // 記録は解放毎（最低保持以上の間隔）なのですぐ揃う
+    }
+  }
+
+  //==================== 実行時設定 ====================
+  static SupervisorTuning tuning() {
+    return tuningSnapshot(tuning_);
+  }
+
+  // 範囲外なら何も変えずに false。各値は次の判定/タイマ起動から有効
+  // （アサート中のKILLは起動済みのタイマのまま解放される）
+  static bool setTuning(const SupervisorTuning& t) {
+    if (!tuningValid<Config>(t)) return false;
+    tuningStore(tuning_, t);
+    P::ledActiveHigh(t.ledActiveHigh != 0);
+    return true;
+  }
+  static void resetTuning() {
+    setTuning(SupervisorTuning::of<Config>());
+  }
+
+  //==================== ライトスリープ（LOW_POWER_MODE） ====================
+  // INT=L 継続中はレベル起床が即成立するので眠れない
+  static bool intLow() {
+    return IntPin::low();
+  }
+
+  // 起床条件はレベル割り込みで設定されるため、その間エッジ割り込みは止めておく
+  static void sleepPrepare() {
+    P::sleepPrepare(lastReset_);
+  }
+
+  static void sleepRestore() {
+    P::sleepRestore(); // 睡眠中のレベル検出分も破棄
+  }
+
+  // 睡眠中のエッジはエッジ割り込みで捕捉されないため、起床時刻で合成する
+  // （割り込み禁止下で呼ぶ。ISRを止めている間だけ呼び出し元がイベントリングの生産者になる）
+  static bool sleepSynthesize(usec_t wakeAt) {
+    bool resetNow = ResetPin::high();
+    if (resetNow != lastReset_) recordResetEdge(wakeAt, resetNow);
+#if INT_FILTER_SAMPLED
+    if (IntPin::low()) intFilterBegin(wakeAt); // 判定は安定を待ってから
+    return false;
+#else
+    return IntPin::low() && recordIntFalling(wakeAt);
+#endif
+  }
+
+  static void sleepResume() {
+    P::sleepResume();
+  }
+
+ private:
+  //==================== KILL端子 ====================
+  // 出力ラッチはアクティブレベルに固定しておき（アイドルは Hi-Z ＋非アクティブ側へのプル）、
+  // 以降はISR/タイマからも触れるよう出力有効/無効のレジスタ直書きのみで切り替える
+  static void killLatch() {
+    if (Config::KILL_ACTIVE_LOW) KillPin::clear();
+    else                         KillPin::set();
+  }
+
+  // KILLアイドル: 出力無効化（Hi-Z + 内部プルで非アクティブ維持）
+  static inline void IRAM_ATTR killIdle() {
+    KillPin::release();
+  }
+
+  // KILLアサート: 出力有効化でアクティブレベルを強制
+  static inline void IRAM_ATTR killAssert() {
+    KillPin::drive();
+  }
+
+  // チャネル別の記録は code 上位4bitにチャネル番号を入れる
+  static inline void IRAM_ATTR trace(usec_t atUs, TraceKind kind, uint8_t code) {
+    P::trace(atUs, kind, static_cast<uint8_t>(code | (CHANNEL << 4)));
+  }
+
+  //==================== 起動抑止 / LED ====================
+  // KILL抑止ON（atUs: 抑止の起点、すでに最大時間を過ぎていれば抑止しない）
+  static void startStartupInhibit(usec_t atUs) {
+    P::timerStop(startupInhibitTimer_); // 再起動
+    usec_t remain = Logic::startupInhibitRemainUs(atUs, P::now(), tuning_.startupInhibitMaxUs);
+    startupInhibit_ = remain > 0;
+    if (startupInhibit_) P::timerStartOnce(startupInhibitTimer_, remain);
+  }
+
+  // 起動シーケンス：短点灯×3回 & KILL抑止ON
+  static void startPowerOnSequence(usec_t atUs) {
+    startStartupInhibit(atUs);
+    P::ledPowerOn();
+  }
+
+  // 起動抑止の解除（RESET=L もしくは最大時間経過）
+  static void endStartupInhibit() {
+    P::timerStop(startupInhibitTimer_);
+    startupInhibit_ = false;
+  }
+
+  static void onStartupInhibitTimeout(void*) {
+    startupInhibit_ = false;
+  }
+
+  // 電源OFFシーケンス：やや長い点灯×1回
+  static void powerOffIndication() {
+    P::ledPowerOff();
+  }
+
+  //==================== KILL保持＆解放（タイマ駆動） ====================
+  // アサートしてタイマを起動。すでにアサート中、または requestAtUs（要求の時刻）より後に
+  // アサート済みなら何もしない（ISRからも可）
+  // タイマ操作も killMux_ 内で行い、解放側の停止と入れ違わないようにする
+  static inline bool IRAM_ATTR killBegin(usec_t now, usec_t requestAtUs) {
+    P::lock(killMux_);
+    bool started = !killActive_ && killAssertAtUs_ < requestAtUs;
+    if (started) {
+      killAssert();
+      statInc(stats_.kills);
+      killAssertAtUs_ = now;
+      killHoldDone_   = false;
+      killActive_     = true;
+      const usec_t since = resetHighSinceUs_;
+      killIntAtUs_       = requestAtUs;
+      killOnUs_          = since != 0 ? profileSpan(since, requestAtUs) : PROFILE_NONE;
+      killResetFallAtUs_ = 0;
+      P::timerStartOnce(killHoldTimer_,    tuning_.killMinHoldUs);
+      P::timerStartOnce(killTimeoutTimer_, tuning_.killTimeoutUs);
+    }
+    // 済んだ要求を下ろす（アサート中、または最後のアサートより前に受け付けた要求）
+    if (killActive_ || killRequestAtUs_ <= killAssertAtUs_) killRequestAtUs_ = 0;
+    P::unlock(killMux_);
+    if (started) P::killBoost(true); // アサートを先に、周波数切り替えは後で
+    return started;
+  }
+
+  // 解放（二重呼び出し可、ISR / タイマコールバックから呼ぶ）
+  static inline void IRAM_ATTR killRelease(TraceRelease reason) {
+    PROBE_SCOPE(KillRelease);
+    P::lock(killMux_);
+    bool released = killActive_;
+    if (released) {
+      killIdle();
+      killActive_ = false;
+      const usec_t now = P::now();
+      trace(now, TraceKind::KillRelease, static_cast<uint8_t>(reason));
+      profileRecord(now, reason);
+      statInc(reason == TraceRelease::Timeout  ? stats_.releaseTimeout :
+              reason == TraceRelease::Backstop ? stats_.backstopReleases : stats_.releaseResetLow);
+      P::timerStop(killHoldTimer_);    // 発火済みなら何もしない
+      P::timerStop(killTimeoutTimer_);
+    }
+    P::unlock(killMux_);
+    if (released) P::killBoost(false);
+  }
+
+  // 解放時に今回の電源OFFを1件記録（killMux_ 内から）
+  static inline void IRAM_ATTR profileRecord(usec_t now, TraceRelease reason) {
+    const uint32_t led   = P::ledPlayedUs();
+    const uint32_t sleep = P::sleptUs();
+    PowerCycleProfile p = {};
+    p.onUs          = killOnUs_;
+    p.intToKillUs   = profileSpan(killIntAtUs_, killAssertAtUs_);
+    p.killToResetUs = killResetFallAtUs_ != 0 ? profileSpan(killAssertAtUs_, killResetFallAtUs_) : PROFILE_NONE;
+    p.killHeldUs    = profileSpan(killAssertAtUs_, now);
+    p.ledUs         = led - profileLedSeenUs_;
+    p.sleepUs       = sleep - profileSleepSeenUs_;
+    p.release       = static_cast<uint8_t>(reason);
+    profilePush(profile_, p);
+    profileLedSeenUs_   = led;
+    profileSleepSeenUs_ = sleep;
+  }
+
+  // 最低保持経過: この時点でRESET=Lなら即解放、HならRESET立下りISRに任せる
+  static void onKillHoldElapsed(void*) {
+    killHoldDone_ = true; // 先に立ててからRESETを読む（ISRとの取りこぼし防止）
+    if (Logic::releaseOnHoldElapsed(ResetPin::high())) killRelease(TraceRelease::HoldElapsed);
+  }
+
+  // 念のための上限（RESETがLOWにならなくても解放）
+  static void onKillTimeout(void*) {
+    killRelease(TraceRelease::Timeout);
+  }
+
+  // 監視タスクへ渡すKILL要求（ISR、処理されるまで最古の受付時刻を保持。アサート中は済んでいる）
+  static inline void IRAM_ATTR killRequest(usec_t now) {
+    P::lock(killMux_);
+    if (!killActive_ && killRequestAtUs_ == 0) killRequestAtUs_ = now;
+    P::unlock(killMux_);
+  }
+
+  static inline usec_t IRAM_ATTR killRequestAtUs() {
+    P::lock(killMux_);
+    usec_t at = killRequestAtUs_;
+    P::unlock(killMux_);
+    return at;
+  }
+
+ public:
+  //==================== フェイルセーフ（ハードウェアタイマ割り込み） ====================
+  // タイムアウトのタイマが走らずKILLが残っていれば強制解放し、
+  // 監視タスクが処理しないKILL要求は代わりにアサートする
+  static inline void IRAM_ATTR backstopCheck(usec_t now) {
+    P::lock(killMux_);
+    const bool overdue = killActive_ &&
+        now - killAssertAtUs_ > static_cast<usec_t>(tuning_.killTimeoutUs) + BACKSTOP_RELEASE_MARGIN_US;
+    const usec_t requestAt = killRequestAtUs_;
+    P::unlock(killMux_);
+    if (overdue) {
+      killRelease(TraceRelease::Backstop);
+      P::failsafeNote(FailsafeReason::BackstopRelease);
+    }
+    if (requestAt != 0 && now - requestAt > BACKSTOP_ASSERT_US && killBegin(now, requestAt)) {
+      statInc(stats_.backstopAsserts);
+      P::failsafeNote(FailsafeReason::BackstopAssert);
+    }
+  }
+
+  // ウォッチドッグ発火時（パニック直前）: 状態に関わらず出力だけアイドルへ
+  static inline void IRAM_ATTR forceKillIdle() {
+    killIdle();
+  }
+
+ private:
+
+  //==================== イベント記録 ====================
+  // ISR側: 満杯なら events_.dropped() が増え、監視タスクがピン状態から再同期する
+  // 永続トレースにはリングの空きに関係なく残す
+  // （満杯で捨てたKILL判定も killRequestAtUs_ に残っている）
+  static inline void IRAM_ATTR pushEvent(usec_t atUs, EventType type, IntOutcome outcome) {
+    trace(atUs, static_cast<TraceKind>(type), static_cast<uint8_t>(outcome));
+    const SupervisorEvent ev = {atUs, type, outcome};
+    events_.push(ev);
+  }
+
+  // RESET=H がINTの時点で十分続いていたか
+  static inline bool IRAM_ATTR resetHighLongEnough(usec_t now) {
+    usec_t since = resetHighSinceUs_; // 0なら直前までL
+#if EDGE_CAPTURE_MCPWM
+    // 同じキャプチャタイマ上の差分なので割り込み入口遅延のばらつきを含まない
+    if (since != 0 && resetRiseCapValid_ && (now - since < CAPTURE_WRAP_SAFE_US)) {
+      uint32_t ticks = intFallCap_ - resetRiseCap_;
+      return ticks >= tuning_.resetHighMinUs * CAPTURE_TICKS_PER_US;
+    }
+#endif
+    return Logic::resetHighLongEnough(now, since, tuning_.resetHighMinUs);
+  }
+
+  // RESET=H の開始時刻はエッジの瞬間に刻印（監視タスクの起床遅れを排除）
+  // 割り込み禁止下であればスリープ復帰時の合成エッジにも使う
+  static inline void IRAM_ATTR recordResetEdge(usec_t now, bool high) {
+    PROBE_SCOPE(ResetEdge);
+    if (high) {
+      if (resetHighSinceUs_ == 0) {          // チャタリングで再刻印しない
+        resetHighSinceUs_ = now;
+        P::bootResetEdge(now, true);
+      }
+    } else {
+      resetHighSinceUs_ = 0;
+      P::bootResetEdge(now, false);
+      if (killActive_ && killResetFallAtUs_ == 0) killResetFallAtUs_ = now; // プロファイル用
+      // 最低保持経過後のRESET立下りでKILL解放（エッジの瞬間に実施）
+      if (Logic::releaseOnResetFall(killActive_, killHoldDone_)) killRelease(TraceRelease::ResetFall);
+    }
+    pushEvent(now, high ? EventType::ResetRise : EventType::ResetFall, IntOutcome::None);
+  }
+
+  // INT直前に RESET=H が十分続いていたかで KILL可否を即決し、結果ごと記録
+  // （デバウンスで捨てたエッジも記録するが、監視タスクは起こさないので false）
+  static inline bool IRAM_ATTR recordIntFalling(usec_t now) {
+    PROBE_SCOPE(IntFalling);
+    statInc(stats_.intEdges);
+    if (!Logic::intAccept(now, intLastAcceptedUs_, tuning_.intDebounceUs)) { // デバウンス
+      statInc(stats_.intDebounced);
+      pushEvent(now, EventType::IntFall, IntOutcome::Debounced);
+      return false;
+    }
+
+    const IntOutcome outcome = Logic::intOutcome(resetHighLongEnough(now), startupInhibit_);
+    if (outcome == IntOutcome::ResetTooShort)  statInc(stats_.suppressedResetShort);
+    if (outcome == IntOutcome::StartupInhibit) statInc(stats_.suppressedInhibit);
+#if KILL_ASSERT_IN_ISR
+    if (outcome == IntOutcome::Kill && killBegin(now, now)) {
+      statMax(stats_.maxKillLatencyUs, static_cast<uint32_t>(P::now() - now));
+    }
+#else
+    if (outcome == IntOutcome::Kill) killRequest(P::now()); // 判定時刻より後（INT_FILTER_SAMPLED）でも受付時刻で
+#endif
+    pushEvent(now, EventType::IntFall, outcome);
+    return true;
+  }
+
+  //==================== INT安定判定（INT_FILTER_SAMPLED） ====================
+  // 最初の立下りでINTのエッジ割り込みを止め、タイマの周期サンプリングでレベルを追う。
+  // Lが安定幅続いたら、INTをLレベル割り込みに切り替えてGPIO ISRへ判定を渡す
+  // （イベントリングの生産者をGPIO ISRだけに保つ）。判定の時刻は最初の立下り。
+  // その後Hが安定幅続いたらエッジ割り込みへ戻す。安定幅は tuning_.intFilterUs。
+#if INT_FILTER_SAMPLED
+  // 安定待ちを開始（ISR / 監視側のどちらからも可）
+  static inline void IRAM_ATTR intFilterBegin(usec_t now) {
+    P::lock(intFilterMux_);
+    if (!intFiltering_) {
+      intFiltering_      = true;
+      intFilterStartUs_  = now;
+      intFilterLow_      = true;
+      intFilterSamples_  = 0;
+      intFilterConfirmed_ = false;
+      P::intIrq(PinIrq::Disabled); // 以降のチャタリングでは割り込まない
+      P::timerStartPeriodic(intSampleTimer_, Config::INT_FILTER_SAMPLE_US);
+    }
+    P::unlock(intFilterMux_);
+  }
+
+  // GPIO ISR側: サンプラからの引き渡しなら判定、そうでなければ安定待ちを開始
+  static inline bool IRAM_ATTR onIntFilterIrq(usec_t now) {
+    if (intConfirmPending_) {
+      intConfirmPending_ = false;
+      P::intIrq(PinIrq::Disabled); // Lレベル割り込みを止める
+      return recordIntFalling(intFilterStartUs_);
+    }
+    intFilterBegin(now);
+    return false;
+  }
+
+  // サンプラ（タイマタスク）: レベルが変わったら数え直し、安定したら次の段階へ
+  static void onIntSample(void*) {
+    const bool low = IntPin::low();
+    if (low != intFilterLow_) {
+      intFilterLow_     = low;
+      intFilterSamples_ = 0;
+      return;
+    }
+    if (!Logic::intFilterStable(++intFilterSamples_, tuning_.intFilterUs)) return;
+    if (low) {
+      if (!intFilterConfirmed_) {
+        intFilterConfirmed_ = true;
+        intConfirmPending_  = true;
+        P::intIrq(PinIrq::LowLevel); // 即座にGPIO ISRが走る
+      }
+      return; // H安定まで続ける
+    }
+    // H安定: エッジ割り込みへ戻す
+    P::timerStop(intSampleTimer_);
+    if (!intFilterConfirmed_) statInc(stats_.intGlitches);
+    P::lock(intFilterMux_);
+    intConfirmPending_ = false;
+    intFiltering_      = false;
+    P::intStatusClear();         // 停止中に立ったステータスは捨てる
+    P::intIrq(PinIrq::Falling);
+    P::unlock(intFilterMux_);
+    // 戻す直前の立下りを取りこぼさないよう、Lならここから安定待ちを始める
+    if (IntPin::low()) intFilterBegin(P::now());
+  }
+
+  static volatile bool     intFiltering_;      // 安定待ち中（INTのエッジ割り込みは停止）
+  static volatile usec_t   intFilterStartUs_;  // 最初の立下りの時刻
+  static volatile bool     intConfirmPending_; // サンプラ→GPIO ISR の引き渡し待ち
+  static bool              intFilterLow_;      // 以下はサンプラ専用
+  static uint32_t          intFilterSamples_;
+  static bool              intFilterConfirmed_;
+  static Lock              intFilterMux_;
+  static Timer             intSampleTimer_;
+#endif
+
+  //==================== MCPWMキャプチャ（EDGE_CAPTURE_MCPWM、実機のみ） ====================
+#if EDGE_CAPTURE_MCPWM
+  // キャプチャタイマはAPBクロックの32bitフリーラン（80MHzで約53秒周期）
+  static constexpr uint32_t CAPTURE_TICKS_PER_US = APB_CLK_FREQ / 1000000;
+  // この間隔未満なら2エッジのキャプチャ値の差分を信用できる（半周期で余裕をとる）
+  static constexpr usec_t   CAPTURE_WRAP_SAFE_US = static_cast<usec_t>(UINT32_MAX / CAPTURE_TICKS_PER_US) / 2;
+  static_assert(TUNING_RESET_HIGH_MAX_US < CAPTURE_WRAP_SAFE_US,
+                "TUNING_RESET_HIGH_MAX_US must fit in the capture timer range");
+
+  static constexpr mcpwm_capture_channel_id_t CAPTURE_CH_RESET = MCPWM_SELECT_CAP0;
+  static constexpr mcpwm_capture_channel_id_t CAPTURE_CH_INT   = MCPWM_SELECT_CAP1;
+
+ public:
+  // キャプチャ割り込み: ハード刻印値を控えてから通常のエッジ処理へ
+  static bool IRAM_ATTR onEdgeCapture(mcpwm_unit_t, mcpwm_capture_channel_id_t channel,
+                                      const cap_event_data_t* edata, void*) {
+    PROBE_SCOPE(GpioIsr);
+    usec_t now = P::now();
+    if (channel == CAPTURE_CH_RESET) {
+      bool high = (edata->cap_edge == MCPWM_POS_EDGE);
+      if (high && resetHighSinceUs_ == 0) {
+        resetRiseCap_      = edata->cap_value;
+        resetRiseCapValid_ = true;
+      }
+      recordResetEdge(now, high);
+      P::notifyFromIsr();
+    } else {
+      intFallCap_ = edata->cap_value;
+      if (recordIntFalling(now)) P::notifyFromIsr();
+    }
+    return false; // 起床したタスクへの切り替えは notifyFromIsr で要求済み
+  }
+
+ private:
+  // RESET: 両エッジ / INT: 立下り をキャプチャ（入力のプルアップ設定はそのまま）
+  static void captureBegin() {
+    ESP_ERROR_CHECK(mcpwm_gpio_init(MCPWM_UNIT_0, MCPWM_CAP_0, Config::PIN_RESET));
+    ESP_ERROR_CHECK(mcpwm_gpio_init(MCPWM_UNIT_0, MCPWM_CAP_1, Config::PIN_INT));
+    gpio_pullup_en((gpio_num_t)Config::PIN_INT);
+    const mcpwm_capture_config_t resetCfg = {
+      .cap_edge = MCPWM_BOTH_EDGE, .cap_prescale = 1,
+      .capture_cb = onEdgeCapture, .user_data = nullptr,
+    };
+    const mcpwm_capture_config_t intCfg = {
+      .cap_edge = MCPWM_NEG_EDGE, .cap_prescale = 1,
+      .capture_cb = onEdgeCapture, .user_data = nullptr,
+    };
+    ESP_ERROR_CHECK(mcpwm_capture_enable_channel(MCPWM_UNIT_0, CAPTURE_CH_RESET, &resetCfg));
+    ESP_ERROR_CHECK(mcpwm_capture_enable_channel(MCPWM_UNIT_0, CAPTURE_CH_INT,   &intCfg));
+  }
+
+  static volatile uint32_t resetRiseCap_;      // resetHighSinceUs_ を刻印した立上りのキャプチャ値
+  static volatile bool     resetRiseCapValid_; // 起動時のようにソフト刻印しか無ければ false
+  static volatile uint32_t intFallCap_;        // 判定中のINT立下りのキャプチャ値
+#endif
+
+  //==================== 監視タスク側の処理 ====================
+  // RESETエッジ処理（ISRが刻印したエッジのみでLEDアクション）
+  static void handleResetEdge(const SupervisorEvent& ev) {
+    bool high = (ev.type == EventType::ResetRise);
+    if (high == lastReset_) return; // 同レベルの連続（チャタリング）は無視
+    if (high) {
+      // 立上り: 電源ONインジケータ（毎回実行）
+      startPowerOnSequence(ev.atUs);
+    } else {
+      // 立下り: 電源OFFインジケータ、起動抑止はRESETが一度Lになったら解除
+      endStartupInhibit();
+      powerOffIndication();
+    }
+    lastReset_ = high;
+  }
+
+  // INT判定結果の処理（判定自体はISRで済んでいる）
+  static void handleIntFall(const SupervisorEvent& ev) {
+#if KILL_ASSERT_IN_ISR
+    (void)ev; // アサートはISRで実施済み
+#else
+    // フェイルセーフが先にアサートしていれば済んでいる（ev.atUs より後のアサート）
+    if (ev.outcome == IntOutcome::Kill) {
+      usec_t now = P::now();
+      if (killBegin(now, ev.atUs)) statMax(stats_.maxKillLatencyUs, static_cast<uint32_t>(now - ev.atUs));
+    }
+#endif
+  }
+
+  // 取りこぼし時はピン状態へ再同期（刻印は現在時刻で妥協）
+  static void resyncResetLevel() {
+    bool high = ResetPin::high();
+    if (high == lastReset_) return;
+    P::interruptsOff();
+    usec_t now = P::now();
+    resetHighSinceUs_ = high ? now : 0;
+    P::bootResetEdge(now, high);
+    P::interruptsOn();
+    if (!high) endStartupInhibit();
+    lastReset_ = high;
+  }
+
+  // ISR→監視タスク 連携用（必要最小限）
+  static volatile usec_t resetHighSinceUs_;  // RESETがHになった瞬間の刻印（0なら直前までL）
+  static volatile bool   startupInhibit_;
+  static bool            resetCarried_;      // 起動時の RESET=H が前回の起動から続いている
+  static usec_t          intLastAcceptedUs_; // デバウンス基準（起動直後の初回INTも受け付ける）
+  static volatile SupervisorTuning tuning_;   // 時間パラメータ（ISRはフィールド毎にロックなしで読む）
+
+  // イベントリング（ISR→監視タスク、INT/RESETの全エッジを判定結果つきで時系列に）
+  static SpscRing<SupervisorEvent, EVENT_RING_LEN> events_;
+  // 監視タスク生成前・初期化中のRESET変化など、ピン状態から再同期したい時に立てる
+  static volatile bool   resetResyncRequest_;
+
+  // 監視タスク側状態
+  static bool     lastReset_;
+  static uint32_t eventsDroppedSeen_;   // 取りこぼし検出用（events_.dropped() の既読値）
+  static Timer    startupInhibitTimer_; // 抑止の最大時間
+
+  // KILL状態（監視タスク / ISR / タイマタスクから更新されるので killMux_ で保護）
+  static volatile bool   killActive_;
+  static volatile bool   killHoldDone_;     // 最低保持時間が経過済み
+  static volatile usec_t killAssertAtUs_;   // 最後にアサートした時刻
+  static volatile usec_t killRequestAtUs_;  // 未処理のKILL要求の受付時刻（0なら無し、リング満杯時も落とさない）
+  static Lock            killMux_;
+
+  // 電源OFF毎のプロファイル（killBegin() で刻印し、解放時に killMux_ 内で1件にまとめる。
+  // RESET立下りの刻印だけはISRがロックなしで書く）
+  static usec_t          killIntAtUs_;        // アサート中のKILLを受け付けたINT立下り
+  static uint32_t        killOnUs_;           // そのINTまでの RESET=H 継続
+  static volatile usec_t killResetFallAtUs_;  // アサート後の最初のRESET立下り（0なら未だ）
+  static uint32_t        profileLedSeenUs_;   // 前回の記録時の ledPlayedUs()
+  static uint32_t        profileSleepSeenUs_; // 前回の記録時の sleptUs()
+  static PowerProfileLog profile_;
+
+  // KILL解放用ワンショットタイマ（最低保持 / タイムアウト）
+  static Timer killHoldTimer_;
+  static Timer killTimeoutTimer_;
+
+  // 稼働統計（各カウンタの書き手は1か所: ISR、または killMux_ 内）
+  static volatile SupervisorStats stats_;
+};
+
+template <typename C, typename P> volatile usec_t SupervisorCore<C, P>::resetHighSinceUs_ = 0;
+template <typename C, typename P> volatile bool   SupervisorCore<C, P>::startupInhibit_ = false;
+template <typename C, typename P> bool            SupervisorCore<C, P>::resetCarried_ = false;
+template <typename C, typename P> usec_t          SupervisorCore<C, P>::intLastAcceptedUs_ = -static_cast<usec_t>(TUNING_DEBOUNCE_MAX_US);
+template <typename C, typename P> volatile SupervisorTuning SupervisorCore<C, P>::tuning_ = SupervisorTuning::of<C>();
+template <typename C, typename P> SpscRing<SupervisorEvent, EVENT_RING_LEN> SupervisorCore<C, P>::events_;
+template <typename C, typename P> volatile bool   SupervisorCore<C, P>::resetResyncRequest_ = false;
+template <typename C, typename P> bool            SupervisorCore<C, P>::lastReset_ = false;
+template <typename C, typename P> uint32_t        SupervisorCore<C, P>::eventsDroppedSeen_ = 0;
+template <typename C, typename P> typename P::Timer SupervisorCore<C, P>::startupInhibitTimer_ = nullptr;
+template <typename C, typename P> volatile bool   SupervisorCore<C, P>::killActive_ = false;
+template <typename C, typename P> volatile bool   SupervisorCore<C, P>::killHoldDone_ = false;
+template <typename C, typename P> volatile usec_t SupervisorCore<C, P>::killAssertAtUs_ = INT64_MIN;
+template <typename C, typename P> volatile usec_t SupervisorCore<C, P>::killRequestAtUs_ = 0;
+template <typename C, typename P> typename P::Lock SupervisorCore<C, P>::killMux_;
+template <typename C, typename P> usec_t          SupervisorCore<C, P>::killIntAtUs_ = 0;
+template <typename C, typename P> uint32_t        SupervisorCore<C, P>::killOnUs_ = PROFILE_NONE;
+template <typename C, typename P> volatile usec_t SupervisorCore<C, P>::killResetFallAtUs_ = 0;
+template <typename C, typename P> uint32_t        SupervisorCore<C, P>::profileLedSeenUs_ = 0;
+template <typename C, typename P> uint32_t        SupervisorCore<C, P>::profileSleepSeenUs_ = 0;
+template <typename C, typename P> PowerProfileLog SupervisorCore<C, P>::profile_ = {};
+template <typename C, typename P> typename P::Timer SupervisorCore<C, P>::killHoldTimer_ = nullptr;
+template <typename C, typename P> typename P::Timer SupervisorCore<C, P>::killTimeoutTimer_ = nullptr;
+template <typename C, typename P> volatile SupervisorStats SupervisorCore<C, P>::stats_ = {};
+#if INT_FILTER_SAMPLED
+template <typename C, typename P> volatile bool   SupervisorCore<C, P>::intFiltering_ = false;
+template <typename C, typename P> volatile usec_t SupervisorCore<C, P>::intFilterStartUs_ = 0;
+template <typename C, typename P> volatile bool   SupervisorCore<C, P>::intConfirmPending_ = false;
+template <typename C, typename P> bool            SupervisorCore<C, P>::intFilterLow_ = false;
+template <typename C, typename P> uint32_t        SupervisorCore<C, P>::intFilterSamples_ = 0;
+template <typename C, typename P> bool            SupervisorCore<C, P>::intFilterConfirmed_ = false;
+template <typename C, typename P> typename P::Lock SupervisorCore<C, P>::intFilterMux_;
+template <typename C, typename P> typename P::Timer SupervisorCore<C, P>::intSampleTimer_ = nullptr;
+#endif
+#if EDGE_CAPTURE_MCPWM
+template <typename C, typename P> volatile uint32_t SupervisorCore<C, P>::resetRiseCap_ = 0;
+template <typename C, typename P> volatile bool     SupervisorCore<C, P>::resetRiseCapValid_ = false;
+template <typename C, typename P> volatile uint32_t SupervisorCore<C, P>::intFallCap_ = 0;
+#endif
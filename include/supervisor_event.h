@@ -0,0 +1,34 @@
+#pragma once
+#include <stdint.h>
+
+//==================== 監視イベント ====================
+// ISRが刻印して監視タスクへ渡すイベント記録
+
+enum class EventType : uint8_t {
+  IntFall   = 0,  // INT立下り（判定結果つき）
+  ResetRise = 1,  // RESET立上り
+  ResetFall = 2,  // RESET立下り
+};
+
+// INT立下りの判定結果（RESETエッジでは None）
+enum class IntOutcome : uint8_t {
+  None           = 0,
+  Kill           = 1,  // KILLすべき
+  Debounced      = 2,  // INT_DEBOUNCE_US 内の再エッジとして捨てた
+  ResetTooShort  = 3,  // RESET=H の継続が RESET_HIGH_MIN_US_BEFORE_INT 未満
+  StartupInhibit = 4,  // 起動抑止中
+};
+
+// KILL解放の理由（永続トレースの KillRelease 記録の code）
+enum class TraceRelease : uint8_t {
+  ResetFall   = 1,  // 最低保持後のRESET立下り
+  HoldElapsed = 2,  // 最低保持経過時点でRESET=L
+  Timeout     = 3,  // KILL_TIMEOUT_US 到達
+  Backstop    = 4,  // タイムアウトを過ぎても解放されずハードウェアタイマで強制解放（failsafe.h）
+};
+
+struct SupervisorEvent {
+  int64_t    atUs;     // エッジ時刻（esp_timer µs）
+  EventType  type;
+  IntOutcome outcome;
+};
@@ -0,0 +1,350 @@
+#pragma once
+#include <stdint.h>
+#include "supervisor_config.h"
+#include "supervisor_core.h"
+
+#if !SUPERVISOR_NATIVE
+  #error "supervisor_host.h is the host (SUPERVISOR_NATIVE=1) platform; the firmware uses supervisor_platform.h"
+#endif
+
+//==================== ホスト実行の疑似ボード（env:native） ====================
+// 仮想時計・GPIO（レベル・割り込み種別・ステータス）・タイマを1本の時系列で進め、
+// 実機と同じ SupervisorCore<Config, Platform> を動かす。実時間は一切待たない。
+// ISR・監視タスク・タイマコールバックはエッジ/期限の時刻に遅れなく順に走るものとして扱い
+// （実機の処理遅延は SUPERVISOR_BENCH で測る）、止まった場合はテストが holdTask / holdTimers で再現する。
+// 全チャネルで1枚を共有する（実機のGPIO割り込みが1本なのと同じ）。
+
+// ISRから見た記録の通知先（呼び出し側が実装、既定は何もしない）
+class HostObserver {
+ public:
+  virtual ~HostObserver() {}
+  virtual void onTrace(usec_t, TraceKind, uint8_t) {}
+  virtual void onKill(usec_t, int /*pin*/, bool /*driven*/) {}
+};
+
+// 共通GPIO割り込みの本体（status: 立っていた担当ビット、in: 入力レベル。監視タスクを起こすなら true）
+using HostIsr  = bool (*)(usec_t now, uint32_t status, uint32_t in);
+using HostTask = void (*)();
+
+struct HostTimer {
+  void (*callback)(void*);
+  usec_t dueUs;
+  usec_t periodUs; // 0ならワンショット
+  bool   armed;
+};
+
+class HostBoard {
+ public:
+  static constexpr int      PINS     = 32;
+  static constexpr uint32_t TIMERS   = 32;
+  static constexpr uint8_t  CHANNELS = 16;
+
+  static HostBoard& get() {
+    static HostBoard board;
+    return board;
+  }
+
+  // すべて初期状態へ（ピンはL・割り込みなし、タイマは破棄、時刻は at）
+  void reset(usec_t at = 0) {
+    *this = HostBoard();
+    now_ = at;
+  }
+
+  void attach(HostIsr isr, HostTask task) {
+    isr_  = isr;
+    task_ = task;
+  }
+  void observe(HostObserver* observer) { observer_ = observer; }
+  HostObserver* observer() const { return observer_; }
+
+  usec_t now() const { return now_; }
+
+  //==================== 時刻 ====================
+  // t まで進め、期限を迎えたタイマを時刻順に実行（同時刻は作成順）
+  void advanceTo(usec_t t) {
+    while (!timersHeld_) {
+      HostTimer* due = nullptr;
+      for (uint32_t i = 0; i < timerCount_; ++i) {
+        HostTimer& tm = timers_[i];
+        if (tm.armed && tm.dueUs <= t && (due == nullptr || tm.dueUs < due->dueUs)) due = &tm;
+      }
+      if (due == nullptr) break;
+      if (due->dueUs > now_) now_ = due->dueUs;
+      if (due->periodUs > 0) due->dueUs += due->periodUs;
+      else                   due->armed = false;
+      due->callback(nullptr);
+      service();
+    }
+    if (t > now_) now_ = t;
+  }
+
+  // タイマタスク / 監視タスクが止まった状態の再現（解除すると溜まった分を今の時刻で実行）
+  void holdTimers(bool hold) {
+    timersHeld_ = hold;
+    if (!hold) advanceTo(now_);
+  }
+  void holdTask(bool hold) {
+    taskHeld_ = hold;
+    if (!hold) service();
+  }
+
+  //==================== GPIO ====================
+  // 外部からのレベル変化（時刻を進めてから。同レベルの再設定は何もしない）
+  void input(usec_t at, int pin, bool high) {
+    advanceTo(at);
+    const uint32_t mask = 1u << pin;
+    external_[pin] = true;
+    if (((inputs_ & mask) != 0) == high) return;
+    inputs_ = high ? (inputs_ | mask) : (inputs_ & ~mask);
+    if (!high) {
+      for (uint8_t ch = 0; ch < CHANNELS; ++ch) {
+        if (pcntPin_[ch] == pin) ++pcntCount_[ch];
+      }
+    }
+    const uint8_t type = irqType_[pin];
+    if (type == IRQ_ANY_EDGE || (type == IRQ_FALLING && !high)) status_ |= mask;
+    service();
+  }
+
+  // パッドのレベル（出力有効ならラッチ、そうでなければ外部入力、未駆動ならプル）
+  bool level(int pin) const {
+    const uint32_t mask = 1u << pin;
+    if (outEnable_ & mask) return (outLatch_ & mask) != 0;
+    return (inputs_ & mask) != 0;
+  }
+  uint32_t levels() const {
+    return (inputs_ & ~outEnable_) | (outLatch_ & outEnable_);
+  }
+  bool driven(int pin) const { return (outEnable_ & (1u << pin)) != 0; }
+
+  void latch(int pin, bool high) {
+    outLatch_ = high ? (outLatch_ | (1u << pin)) : (outLatch_ & ~(1u << pin));
+  }
+  void drive(int pin, bool enable) {
+    const uint32_t mask = 1u << pin;
+    if (((outEnable_ & mask) != 0) == enable) return;
+    outEnable_ = enable ? (outEnable_ | mask) : (outEnable_ & ~mask);
+    if (observer_ != nullptr) observer_->onKill(now_, pin, enable);
+  }
+  // プルは外から駆動されていないピンのレベルとして扱う
+  void pull(int pin, bool up) {
+    if (!external_[pin]) inputs_ = up ? (inputs_ | (1u << pin)) : (inputs_ & ~(1u << pin));
+  }
+
+  static constexpr uint8_t IRQ_NONE     = 0;
+  static constexpr uint8_t IRQ_FALLING  = 1;
+  static constexpr uint8_t IRQ_ANY_EDGE = 2;
+  static constexpr uint8_t IRQ_LOW      = 3;
+  void irqType(int pin, uint8_t type) { irqType_[pin] = type; }
+  uint8_t irqType(int pin) const { return irqType_[pin]; }
+  void statusClear(uint32_t mask) { status_ &= ~mask; }
+
+  //==================== 割り込み禁止 ====================
+  void interruptsOff() { ++irqOff_; }
+  void interruptsOn() {
+    if (irqOff_ > 0 && --irqOff_ == 0) service();
+  }
+
+  //==================== タイマ ====================
+  HostTimer* timerCreate(void (*callback)(void*)) {
+    if (timerCount_ >= TIMERS) return nullptr;
+    HostTimer& t = timers_[timerCount_++];
+    t.callback = callback;
+    t.armed    = false;
+    return &t;
+  }
+  // esp_timer と同じく、起動中への start は何もしない
+  void timerStart(HostTimer* t, usec_t us, bool periodic) {
+    if (t == nullptr || t->armed) return;
+    t->armed    = true;
+    t->dueUs    = now_ + us;
+    t->periodUs = periodic ? us : 0;
+  }
+  void timerStop(HostTimer* t) {
+    if (t != nullptr) t->armed = false;
+  }
+
+  //==================== 記録先（テストから参照） ====================
+  // RTC_NOINIT の RESET=H 記録（前の起動から続いていたことにするならテストが先に書く）
+  usec_t   bootResetSinceUs[CHANNELS] = {};
+  uint32_t failsafeNotes = 0;
+  FailsafeReason lastFailsafe = FailsafeReason::None;
+  int      killBoostDepth = 0;
+  uint32_t ledPowerOn[CHANNELS]  = {};
+  uint32_t ledPowerOff[CHANNELS] = {};
+  bool     ledActiveHigh[CHANNELS] = {};
+  uint32_t sleptUs = 0;
+
+  // 実機の bootCaptureIntBegin() と同じく、計数中の再開始は何もしない
+  void pcntBegin(uint8_t ch, int pin) {
+    if (pcntPin_[ch] >= 0) return;
+    pcntPin_[ch]   = pin;
+    pcntCount_[ch] = 0;
+  }
+  uint32_t pcntTake(uint8_t ch) {
+    if (pcntPin_[ch] < 0) return 0;
+    pcntPin_[ch] = -1;
+    return pcntCount_[ch];
+  }
+
+ private:
+  HostBoard() {
+    for (uint8_t ch = 0; ch < CHANNELS; ++ch) pcntPin_[ch] = -1;
+  }
+
+  // 保留中のGPIO割り込みを実行し、起こされた監視タスクを走らせる（入れ子にはしない）
+  void service() {
+    if (inService_ || irqOff_ > 0) return;
+    inService_ = true;
+    for (;;) {
+      uint32_t lowLevel = 0;
+      for (int pin = 0; pin < PINS; ++pin) {
+        if (irqType_[pin] == IRQ_LOW && !level(pin)) lowLevel |= 1u << pin;
+      }
+      const uint32_t status = status_ | lowLevel;
+      if (status != 0 && isr_ != nullptr) {
+        status_ = 0; // 共通ハンドラは担当外のビットも落とす
+        if (isr_(now_, status, levels())) notified_ = true;
+        continue;
+      }
+      if (notified_ && !taskHeld_ && task_ != nullptr) {
+        notified_ = false;
+        task_();
+        continue;
+      }
+      break;
+    }
+    inService_ = false;
+  }
+
+  usec_t     now_ = 0;
+  uint32_t   inputs_ = 0;
+  uint32_t   outLatch_ = 0;
+  uint32_t   outEnable_ = 0;
+  uint32_t   status_ = 0;
+  uint8_t    irqType_[PINS] = {};
+  bool       external_[PINS] = {}; // input() で外から駆動した
+  int        irqOff_ = 0;
+  bool       inService_ = false;
+  bool       notified_ = false;
+  bool       taskHeld_ = false;
+  bool       timersHeld_ = false;
+  HostIsr    isr_ = nullptr;
+  HostTask   task_ = nullptr;
+  HostObserver* observer_ = nullptr;
+  HostTimer  timers_[TIMERS] = {};
+  uint32_t   timerCount_ = 0;
+  int        pcntPin_[CHANNELS];
+  uint32_t   pcntCount_[CHANNELS] = {};
+};
+
+//==================== ホストの Platform（SupervisorCore 用） ====================
+template <int PIN>
+struct HostGpio {
+  static_assert(PIN >= 0 && PIN < HostBoard::PINS, "host pins are GPIO0-31");
+  static constexpr uint32_t MASK = 1u << PIN;
+
+  static bool high() { return HostBoard::get().level(PIN); }
+  static bool low()  { return !HostBoard::get().level(PIN); }
+  static void set()     { HostBoard::get().latch(PIN, true); }
+  static void clear()   { HostBoard::get().latch(PIN, false); }
+  static void drive()   { HostBoard::get().drive(PIN, true); }
+  static void release() { HostBoard::get().drive(PIN, false); }
+  static void padPull(bool up) { HostBoard::get().pull(PIN, up); }
+};
+
+template <typename Config>
+struct HostSupervisorPlatform {
+  using ResetPin = HostGpio<Config::PIN_RESET>;
+  using IntPin   = HostGpio<Config::PIN_INT>;
+  using KillPin  = HostGpio<Config::PIN_KILL>;
+  using Timer    = HostTimer*;
+  struct Lock {}; // 1本の時系列で走るので排他は不要
+
+  static HostBoard& board() { return HostBoard::get(); }
+  static usec_t now() { return board().now(); }
+
+  static void pinsInit() {
+    board().pull(Config::PIN_INT, true);
+    board().pull(Config::PIN_KILL, Config::KILL_ACTIVE_LOW);
+  }
+  static void resetIrqEnable() { board().irqType(Config::PIN_RESET, HostBoard::IRQ_ANY_EDGE); }
+  static void intIrqEnable()   { board().irqType(Config::PIN_INT,   HostBoard::IRQ_FALLING); }
+  static void intIrq(PinIrq irq) {
+    board().irqType(Config::PIN_INT, irq == PinIrq::Falling  ? HostBoard::IRQ_FALLING :
+                                     irq == PinIrq::LowLevel ? HostBoard::IRQ_LOW : HostBoard::IRQ_NONE);
+  }
+  static void intStatusClear() { board().statusClear(IntPin::MASK); }
+
+  static void lock(Lock&) {}
+  static void unlock(Lock&) {}
+  static void interruptsOff() { board().interruptsOff(); }
+  static void interruptsOn()  { board().interruptsOn(); }
+
+  static Timer timerCreate(void (*callback)(void*), const char*) { return board().timerCreate(callback); }
+  static void  timerStartOnce(Timer t, usec_t us)     { board().timerStart(t, us, false); }
+  static void  timerStartPeriodic(Timer t, usec_t us) { board().timerStart(t, us, true); }
+  static void  timerStop(Timer t)                     { board().timerStop(t); }
+
+  static void trace(usec_t atUs, TraceKind kind, uint8_t code) {
+    if (board().observer() != nullptr) board().observer()->onTrace(atUs, kind, code);
+  }
+  static void bootResetEdge(usec_t atUs, bool high) {
+    board().bootResetSinceUs[Config::CHANNEL] = high ? atUs : 0;
+  }
+  static bool bootResetHighSince(usec_t& sinceUs) {
+    const usec_t since = board().bootResetSinceUs[Config::CHANNEL];
+    if (since == 0) return false;
+    sinceUs = since;
+    return true;
+  }
+  static void     bootIntBegin() { board().pcntBegin(Config::CHANNEL, Config::PIN_INT); }
+  static uint32_t bootIntTake()  { return board().pcntTake(Config::CHANNEL); }
+  static void killBoost(bool on) { board().killBoostDepth += on ? 1 : -1; }
+  static void failsafeNote(FailsafeReason reason) {
+    ++board().failsafeNotes;
+    board().lastFailsafe = reason;
+  }
+  static uint32_t sleptUs() { return board().sleptUs; }
+
+  static void ledPinBegin() {}
+  static void ledBegin(int) {}
+  static void ledPowerOn()  { ++board().ledPowerOn[Config::CHANNEL]; }
+  static void ledPowerOff() { ++board().ledPowerOff[Config::CHANNEL]; }
+  static bool ledIdle() { return true; }
+  static void ledActiveHigh(bool activeHigh) { board().ledActiveHigh[Config::CHANNEL] = activeHigh; }
+  static uint32_t ledPlayedUs() { return 0; }
+};
+
+template <typename Config>
+using HostSupervisor = SupervisorCore<Config, HostSupervisorPlatform<Config>>;
+
+//==================== 1チャネルを疑似ボードで動かす ====================
+// start() で setup() と同じ順（pinsBegin → begin → arm → 監視タスクの初回処理）に立ち上げ、
+// 以降は reset() / intLevel() でピンを動かし、advanceTo() で時刻を進める
+template <typename Config>
+struct HostRig {
+  using Sv = HostSupervisor<Config>;
+
+  static HostBoard& board() { return HostBoard::get(); }
+
+  static bool isr(usec_t now, uint32_t status, uint32_t in) { return Sv::onGpioBatch(now, status, in); }
+  static void task() { Sv::handleEvents(); }
+
+  // 疑似ボードは reset() 済みであること（bootResetSinceUs などはその後に設定できる）
+  static void start(usec_t at, bool resetHigh, bool intHigh = true) {
+    board().advanceTo(at);
+    board().attach(isr, task);
+    board().input(at, Config::PIN_RESET, resetHigh);
+    board().input(at, Config::PIN_INT, intHigh);
+    Sv::pinsBegin();
+    Sv::begin(0);
+    Sv::arm();
+    Sv::handleEvents();
+  }
+
+  static void reset(usec_t at, bool high)    { board().input(at, Config::PIN_RESET, high); }
+  static void intLevel(usec_t at, bool high) { board().input(at, Config::PIN_INT, high); }
+  static void advanceTo(usec_t t)            { board().advanceTo(t); }
+  static bool kill()                         { return board().driven(Config::PIN_KILL); }
+};
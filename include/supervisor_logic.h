@@ -0,0 +1,52 @@
+#pragma once
+#include <stdint.h>
+#include "supervisor_config.h"
+#include "supervisor_event.h"
+
+//==================== 判定ロジック（ハード非依存） ====================
+// INT/RESET/KILL の判定規則だけをまとめたもの。時刻は呼び出し側が渡し、
+// ピン・タイマ・割り込みには触れない。SupervisorCore の ISR/タイマ経路が使い、
+// ホスト実行（env:native）でも同じ SupervisorCore を疑似ボード（supervisor_host.h）で動かす。
+// 実行時に変えられる閾値（SupervisorTuning）は呼び出し側が引数で渡す。
+// ISR経路から呼ばれるので always_inline で呼び出し元（IRAM_ATTR）へ展開させる。
+#define SUPERVISOR_LOGIC_INLINE inline __attribute__((always_inline))
+
+template <typename Config>
+struct SupervisorLogic {
+  // INT立下りのデバウンス: 受け付けたら基準時刻を更新して true
+  static SUPERVISOR_LOGIC_INLINE bool intAccept(usec_t now, usec_t& lastAcceptedUs, usec_t debounceUs) {
+    if (now - lastAcceptedUs < debounceUs) return false;
+    lastAcceptedUs = now;
+    return true;
+  }
+
+  // RESET=H がINTの時点で十分続いていたか（since: H開始の刻印、0ならL、minUs: 必要な継続）
+  static SUPERVISOR_LOGIC_INLINE bool resetHighLongEnough(usec_t now, usec_t since, usec_t minUs) {
+    return since != 0 && now - since >= minUs;
+  }
+
+  // デバウンスを通ったINT立下りの判定
+  static SUPERVISOR_LOGIC_INLINE IntOutcome intOutcome(bool resetLongEnough, bool startupInhibit) {
+    if (!resetLongEnough) return IntOutcome::ResetTooShort;
+    if (startupInhibit)   return IntOutcome::StartupInhibit; // 起動直後の点滅中はKILL抑止
+    return IntOutcome::Kill;
+  }
+
+  // INT_FILTER_SAMPLED: 同じレベルが samples 回続いたら安定（filterUs: 安定幅）
+  static SUPERVISOR_LOGIC_INLINE bool intFilterStable(uint32_t samples, usec_t filterUs) {
+    return static_cast<usec_t>(samples) * Config::INT_FILTER_SAMPLE_US >= filterUs;
+  }
+
+  // 起動抑止の残り時間（atUs: 抑止の起点、maxUs: 抑止の上限、0以下なら抑止しない）
+  static SUPERVISOR_LOGIC_INLINE usec_t startupInhibitRemainUs(usec_t atUs, usec_t now, usec_t maxUs) {
+    return atUs + maxUs - now;
+  }
+
+  // KILL解放の条件（最低保持の経過とRESET=Lの両方、またはタイムアウト）
+  static SUPERVISOR_LOGIC_INLINE bool releaseOnResetFall(bool killActive, bool holdDone) {
+    return killActive && holdDone;
+  }
+  static SUPERVISOR_LOGIC_INLINE bool releaseOnHoldElapsed(bool resetHigh) {
+    return !resetHigh; // Hなら次のRESET立下りで解放
+  }
+};
@@ -0,0 +1,159 @@
+#pragma once
+#include <stdint.h>
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <soc/gpio_struct.h>
+#include <driver/gpio.h>
+#include "supervisor_config.h"
+#include "supervisor_core.h"
+#include "fast_gpio.h"
+#include "led_sequencer.h"
+#include "trace_log.h"
+#include "power_profile.h"
+#include "boot_capture.h"
+#include "cpu_dfs.h"
+#include "failsafe.h"
+
+//==================== 監視タスク（全チャネル共通） ====================
+// 監視タスクへの通知ビット
+constexpr uint32_t NOTIFY_EVENT = 1u << 0; // いずれかのイベントリングに新着あり
+
+extern TaskHandle_t g_supervisorTask; // 生成前は nullptr
+
+// 監視タスク生成前のイベントはリング/フラグに残り、生成直後にまとめて処理される
+// 監視タスクが処理し終えるまでCPUを最大周波数に保つ（SUPERVISOR_DFS）
+inline void IRAM_ATTR notifySupervisorFromIsr(uint32_t bits) {
+  dfsHoldEventFromIsr();
+  if (g_supervisorTask == nullptr) return;
+  BaseType_t woken = pdFALSE;
+  xTaskNotifyFromISR(g_supervisorTask, bits, eSetBits, &woken);
+  if (woken == pdTRUE) portYIELD_FROM_ISR();
+}
+
+//==================== GPIO割り込み ====================
+// 全チャネルのINT/RESETを1本のGPIO割り込み（SupervisorSet::onGpioInterrupt）で受ける。
+// ピン毎の割り込みは種別設定と有効化だけで、ハンドラの登録はしない
+// （呼び出したコアへルーティングされる）。
+inline void enablePinInterrupt(int pin, gpio_int_type_t type) {
+  gpio_set_intr_type((gpio_num_t)pin, type);
+  gpio_intr_enable((gpio_num_t)pin);
+}
+
+// esp_timerタスクで動くワンショット/周期タイマを作成
+inline esp_timer_handle_t createTaskTimer(esp_timer_cb_t callback, const char* name) {
+  const esp_timer_create_args_t args = {
+    .callback = callback, .arg = nullptr,
+    .dispatch_method = ESP_TIMER_TASK, .name = name,
+    .skip_unhandled_events = false,
+  };
+  esp_timer_handle_t timer = nullptr;
+  ESP_ERROR_CHECK(esp_timer_create(&args, &timer));
+  return timer;
+}
+
+//==================== 実機の Platform（SupervisorCore 用） ====================
+// ピンはレジスタ直（FastGpio）、タイマは esp_timer、排他はスピンロック、
+// 記録先はトレース・起動捕捉・DFS・フェイルセーフ・LEDシーケンサの各モジュール
+#define SUPERVISOR_PLATFORM_INLINE inline __attribute__((always_inline))
+
+template <typename Config>
+struct EspSupervisorPlatform {
+  // GPIO.in/out/enable/status の直アクセスは GPIO0〜31 のみ
+  static_assert(Config::PIN_RESET < 32 && Config::PIN_INT < 32 && Config::PIN_KILL < 32,
+                "supervisor pins must be in GPIO bank 0 for direct register access");
+
+  // 監視タスク/タイマ側の読み出しも含め、初期設定以外のピン操作はすべてレジスタ直
+  using ResetPin = FastGpio<Config::PIN_RESET>;
+  using IntPin   = FastGpio<Config::PIN_INT>;
+  using KillPin  = FastGpio<Config::PIN_KILL>;
+  using Timer    = esp_timer_handle_t;
+
+  struct Lock {
+    portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+  };
+
+  static SUPERVISOR_PLATFORM_INLINE usec_t now() { return nowUs(); }
+
+  //==================== ピン ====================
+  // KILL: Hi-Z + 非アクティブ側へ内部プル（出力ラッチは SupervisorCore が設定）
+  static void pinsInit() {
+    pinMode(Config::PIN_RESET, INPUT);          // TPS3424のpush-pull出力を受ける
+    pinMode(Config::PIN_INT,   INPUT_PULLUP);   // OD想定でプルアップ
+    pinMode(Config::PIN_KILL,  Config::KILL_ACTIVE_LOW ? INPUT_PULLUP : INPUT_PULLDOWN);
+  }
+  static void resetIrqEnable() { enablePinInterrupt(Config::PIN_RESET, GPIO_INTR_ANYEDGE); }
+  static void intIrqEnable()   { enablePinInterrupt(Config::PIN_INT,   GPIO_INTR_NEGEDGE); }
+
+  static SUPERVISOR_PLATFORM_INLINE void intIrq(PinIrq irq) {
+    IntPin::intType(irq == PinIrq::Falling  ? GPIO_INTR_NEGEDGE :
+                    irq == PinIrq::LowLevel ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_DISABLE);
+  }
+  static SUPERVISOR_PLATFORM_INLINE void intStatusClear() { GPIO.status_w1tc = IntPin::MASK; }
+
+  //==================== 排他 ====================
+  static SUPERVISOR_PLATFORM_INLINE void lock(Lock& l)   { portENTER_CRITICAL_SAFE(&l.mux); }
+  static SUPERVISOR_PLATFORM_INLINE void unlock(Lock& l) { portEXIT_CRITICAL_SAFE(&l.mux); }
+  static SUPERVISOR_PLATFORM_INLINE void interruptsOff() { noInterrupts(); }
+  static SUPERVISOR_PLATFORM_INLINE void interruptsOn()  { interrupts(); }
+
+  //==================== タイマ（esp_timer タスク） ====================
+  static Timer timerCreate(esp_timer_cb_t callback, const char* name) {
+    return createTaskTimer(callback, name);
+  }
+  // 起動中への start / 停止中への stop はエラーが返るだけ
+  static SUPERVISOR_PLATFORM_INLINE void timerStartOnce(Timer t, uint64_t us)     { esp_timer_start_once(t, us); }
+  static SUPERVISOR_PLATFORM_INLINE void timerStartPeriodic(Timer t, uint64_t us) { esp_timer_start_periodic(t, us); }
+  static SUPERVISOR_PLATFORM_INLINE void timerStop(Timer t)                       { esp_timer_stop(t); }
+
+  //==================== 記録先 ====================
+  static SUPERVISOR_PLATFORM_INLINE void trace(usec_t atUs, TraceKind kind, uint8_t code) {
+    traceWrite(atUs, kind, code);
+  }
+  static SUPERVISOR_PLATFORM_INLINE void bootResetEdge(usec_t atUs, bool high) {
+    bootCaptureResetEdge(Config::CHANNEL, atUs, high);
+  }
+  static bool     bootResetHighSince(usec_t& sinceUs) { return bootCaptureResetHighSince(Config::CHANNEL, sinceUs); }
+  static void     bootIntBegin()                      { bootCaptureIntBegin(Config::CHANNEL, Config::PIN_INT); }
+  static uint32_t bootIntTake()                       { return bootCaptureIntTake(Config::CHANNEL); }
+  static SUPERVISOR_PLATFORM_INLINE void killBoost(bool on) {
+    if (on) dfsAcquire(DfsHold::Kill);
+    else    dfsRelease(DfsHold::Kill);
+  }
+  static SUPERVISOR_PLATFORM_INLINE void failsafeNote(FailsafeReason reason) {
+    ::failsafeNote(reason, Config::CHANNEL);
+  }
+  static SUPERVISOR_PLATFORM_INLINE uint32_t sleptUs()  { return g_profileSleepUs; }
+  static SUPERVISOR_PLATFORM_INLINE void notifyFromIsr() { notifySupervisorFromIsr(NOTIFY_EVENT); }
+
+  //==================== LED ====================
+  static void ledPinBegin()                  { Led<Config>::pinBegin(); }
+  static void ledBegin(int core)             { Led<Config>::begin(core); }
+  static void ledPowerOn()                   { Led<Config>::request(LED_PATTERN_POWER_ON); }
+  static void ledPowerOff()                  { Led<Config>::request(LED_PATTERN_POWER_OFF); }
+  static bool ledIdle()                      { return Led<Config>::idle(); }
+  static void ledActiveHigh(bool activeHigh) { Led<Config>::setActiveHigh(activeHigh); }
+  static SUPERVISOR_PLATFORM_INLINE uint32_t ledPlayedUs() { return Led<Config>::playedUs(); }
+
+  //==================== ライトスリープ（LOW_POWER_MODE） ====================
+  // 起床条件はレベル割り込みで設定されるため、その間エッジ割り込みは止めておく
+  static void sleepPrepare(bool resetHigh) {
+    gpio_intr_disable((gpio_num_t)Config::PIN_INT);
+    gpio_intr_disable((gpio_num_t)Config::PIN_RESET);
+    gpio_wakeup_enable((gpio_num_t)Config::PIN_INT,   GPIO_INTR_LOW_LEVEL);
+    gpio_wakeup_enable((gpio_num_t)Config::PIN_RESET,
+                       resetHigh ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+  }
+
+  static void sleepRestore() {
+    gpio_wakeup_disable((gpio_num_t)Config::PIN_INT);
+    gpio_wakeup_disable((gpio_num_t)Config::PIN_RESET);
+    gpio_set_intr_type((gpio_num_t)Config::PIN_INT,   GPIO_INTR_NEGEDGE);
+    gpio_set_intr_type((gpio_num_t)Config::PIN_RESET, GPIO_INTR_ANYEDGE);
+    GPIO.status_w1tc = IntPin::MASK | ResetPin::MASK; // 睡眠中のレベル検出分を破棄
+  }
+
+  static void sleepResume() {
+    gpio_intr_enable((gpio_num_t)Config::PIN_INT);
+    gpio_intr_enable((gpio_num_t)Config::PIN_RESET);
+  }
+};
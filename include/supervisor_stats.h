@@ -0,0 +1,52 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "supervisor_config.h"
+
+//==================== 稼働統計 ====================
+// 常時有効のカウンタ（チャネル毎）。各カウンタの書き手は1か所（ISR、またはKILLのmux内）なので
+// ロックなしで加算し、読み出し側は多少の不整合を許容する。
+
+struct SupervisorStats {
+  uint32_t intEdges;             // INT立下り（デバウンスで捨てたものを含む）
+  uint32_t intDebounced;         // INT_DEBOUNCE_US 内の再エッジとして捨てた
+  uint32_t suppressedInhibit;    // 起動抑止中でKILLしなかった
+  uint32_t suppressedResetShort; // RESET=H 継続不足でKILLしなかった
+  uint32_t kills;                // KILLアサート
+  uint32_t releaseResetLow;      // 最低保持後のRESET=Lで解放
+  uint32_t releaseTimeout;       // KILL_TIMEOUT_US で解放
+  uint32_t eventsDropped;        // イベントリング満杯で捨てた累計（出力時に埋める、消去対象外）
+  uint32_t maxKillLatencyUs;     // INT立下り→KILLアサートの最大値
+  uint32_t intGlitches;          // INT_FILTER_SAMPLED: 安定せずに戻った立下り（判定前に捨てた）
+  uint32_t backstopReleases;     // タイムアウトを過ぎたKILLをハードウェアタイマで解放
+  uint32_t backstopAsserts;      // 処理されないKILL要求をハードウェアタイマでアサート
+};
+
+inline void IRAM_ATTR statInc(volatile uint32_t& counter) {
+  counter = counter + 1;
+}
+
+inline void IRAM_ATTR statMax(volatile uint32_t& peak, uint32_t value) {
+  if (value > peak) peak = value;
+}
+
+static_assert(sizeof(SupervisorStats) % sizeof(uint32_t) == 0, "SupervisorStats must be all u32");
+
+// 出力用スナップショット（eventsDropped は呼び出し側が埋める）
+inline SupervisorStats statsSnapshot(const volatile SupervisorStats& live) {
+  SupervisorStats s;
+  const volatile uint32_t* src = reinterpret_cast<const volatile uint32_t*>(&live);
+  uint32_t* dst = reinterpret_cast<uint32_t*>(&s);
+  for (size_t i = 0; i < sizeof(s) / sizeof(uint32_t); ++i) dst[i] = src[i];
+  return s;
+}
+
+inline void statsClear(volatile SupervisorStats& live) {
+  volatile uint32_t* dst = reinterpret_cast<volatile uint32_t*>(&live);
+  for (size_t i = 0; i < sizeof(live) / sizeof(uint32_t); ++i) dst[i] = 0;
+}
+// FrameWriter形式、ペイロード: u16 fieldCount | u16 channelCount | (u32 × fieldCount) × channelCount
+// （フィールドは上の宣言順、チャネルは番号順）
+void statsDumpBinary(Print& out, const SupervisorStats* channels, uint16_t count);
+// チャネル毎に1行のテキスト（"ch=N key=value ..." を空白区切り）
+void statsPrintLine(Print& out, uint8_t channel, const SupervisorStats& s);
@@ -0,0 +1,64 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "supervisor_config.h"
+
+//==================== 実行時に変えられる設定 ====================
+// 時間パラメータとLED極性のチャネル毎の写し（DRAM）。ISRは各フィールドをロックなしで読む
+// （すべて u32 なので1フィールドの読み書きは分断されない。更新中の数µsは新旧が混ざり得る）。
+// 初期値は Config の定数、起動後に NVS の保存値で上書きする（tuning_store.h）。
+struct SupervisorTuning {
+  uint32_t killMinHoldUs;
+  uint32_t killTimeoutUs;
+  uint32_t intDebounceUs;
+  uint32_t resetHighMinUs;
+  uint32_t startupInhibitMaxUs;
+  uint32_t intFilterUs;          // INT_FILTER_SAMPLED のみ使用
+  uint32_t ledActiveHigh;        // 0/1
+
+  template <typename Config>
+  static constexpr SupervisorTuning of() {
+    return SupervisorTuning{
+      static_cast<uint32_t>(Config::KILL_MIN_HOLD_US),
+      static_cast<uint32_t>(Config::KILL_TIMEOUT_US),
+      static_cast<uint32_t>(Config::INT_DEBOUNCE_US),
+      static_cast<uint32_t>(Config::RESET_HIGH_MIN_US_BEFORE_INT),
+      static_cast<uint32_t>(Config::STARTUP_INHIBIT_MAX_US),
+      static_cast<uint32_t>(Config::INT_FILTER_US),
+      Config::LED_ACTIVE_HIGH ? 1u : 0u,
+    };
+  }
+};
+static_assert(sizeof(SupervisorTuning) % sizeof(uint32_t) == 0, "SupervisorTuning must be all u32");
+
+// 受け付ける範囲（NVSの壊れた値やシリアルの打ち間違いを弾く）
+constexpr uint32_t TUNING_KILL_TIMEOUT_MAX_US   = 60000000;
+constexpr uint32_t TUNING_DEBOUNCE_MAX_US       = 1000000;
+constexpr uint32_t TUNING_RESET_HIGH_MAX_US     = 10000000;
+constexpr uint32_t TUNING_STARTUP_INHIBIT_MAX_US = 60000000;
+
+template <typename Config>
+inline bool tuningValid(const SupervisorTuning& t) {
+  return t.killMinHoldUs > 0 && t.killMinHoldUs < t.killTimeoutUs &&
+         t.killTimeoutUs <= TUNING_KILL_TIMEOUT_MAX_US &&
+         t.intDebounceUs <= TUNING_DEBOUNCE_MAX_US &&
+         t.resetHighMinUs <= TUNING_RESET_HIGH_MAX_US &&
+         t.startupInhibitMaxUs <= TUNING_STARTUP_INHIBIT_MAX_US &&
+         t.intFilterUs >= Config::INT_FILTER_SAMPLE_US && t.intFilterUs <= Config::INT_FILTER_MAX_US &&
+         t.ledActiveHigh <= 1;
+}
+
+// 出力用スナップショット / 反映（フィールド毎の u32 読み書き）
+inline SupervisorTuning tuningSnapshot(const volatile SupervisorTuning& live) {
+  SupervisorTuning t;
+  const volatile uint32_t* src = reinterpret_cast<const volatile uint32_t*>(&live);
+  uint32_t* dst = reinterpret_cast<uint32_t*>(&t);
+  for (size_t i = 0; i < sizeof(t) / sizeof(uint32_t); ++i) dst[i] = src[i];
+  return t;
+}
+
+inline void tuningStore(volatile SupervisorTuning& live, const SupervisorTuning& t) {
+  const uint32_t* src = reinterpret_cast<const uint32_t*>(&t);
+  volatile uint32_t* dst = reinterpret_cast<volatile uint32_t*>(&live);
+  for (size_t i = 0; i < sizeof(t) / sizeof(uint32_t); ++i) dst[i] = src[i];
+}
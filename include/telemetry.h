@@ -0,0 +1,37 @@
+#pragma once
+#include <stdint.h>
+
+//==================== テレメトリ（USB CDC へのバイナリ連続送出） ====================
+// 1: 永続トレースの新しい記録を低優先度タスクがまとめて読み、COBSで包んだフレームを1回の書き込みで送る
+//    （ISR・監視タスクは従来どおりトレースへ数ストア書くだけで、書式化も送信待ちもしない）
+//   フレーム（COBS符号化前、リトルエンディアン）:
+//     u32 magic（送出順に "TLM1"）| u16 frameSeq | u16 count | u32 firstIndex | u32 boots
+//     | TraceRecord × count（8バイト、trace_log.h）| u32 crc32（magic以降、zlib と同じCRC-32）
+//   送出: 0x00 | COBS(フレーム) | 0x00（前後の 0x00 で区切るので、間に挟まったテキスト応答は
+//         CRC不一致の断片として捨てられる）
+//   firstIndex は先頭の記録の書き込み通番（TraceLog::written 基準）。連続しなければ取りこぼし
+//   記録が無くても TELEMETRY_HEARTBEAT_MS 毎に count=0 のフレームを送る（生存確認）
+// 受信側は scripts/telemetry_recv.py
+#ifndef SUPERVISOR_TELEMETRY
+  #define SUPERVISOR_TELEMETRY 0
+#endif
+
+constexpr uint32_t TELEMETRY_PERIOD_MS       = 50;   // 新しい記録の確認周期（送出の最大遅れ）
+constexpr uint32_t TELEMETRY_HEARTBEAT_MS    = 1000;
+constexpr uint16_t TELEMETRY_RECORDS_PER_FRAME = 32; // 1フレームの最大記録数（溜まっていれば続けて送る）
+
+// 送出タスクを起動（traceBegin() の後）
+void telemetryBegin();
+
+// シリアルの応答と送出が混ざらないよう、コマンド処理の間だけ送出を止める（無効時は何もしない）
+void telemetrySerialLock();
+void telemetrySerialUnlock();
+
+// 区間の間だけ telemetrySerialLock()（コマンド1件の応答を包む）
+class TelemetrySerialGuard {
+ public:
+  TelemetrySerialGuard() { telemetrySerialLock(); }
+  ~TelemetrySerialGuard() { telemetrySerialUnlock(); }
+  TelemetrySerialGuard(const TelemetrySerialGuard&) = delete;
+  TelemetrySerialGuard& operator=(const TelemetrySerialGuard&) = delete;
+};
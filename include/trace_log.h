@@ -0,0 +1,68 @@
+#pragma once
+#include <stdint.h>
+#include "supervisor_config.h"
+#include "supervisor_event.h"
+#if !SUPERVISOR_NATIVE
+  #include <esp_attr.h>
+#endif
+
+//==================== 永続トレース ====================
+// RTC_NOINIT に置く固定長の循環トレース。リセット（パニック/WDT/ソフトリセット、ディープスリープ）を
+// 越えて残り、電源投入時だけ消える。ISRから書くので書き込みは数ストアのみ（書式化なし）。
+
+constexpr uint32_t TRACE_LOG_LEN = 256; // 2のべき乗（8B×256 = 2KB）
+static_assert((TRACE_LOG_LEN & (TRACE_LOG_LEN - 1)) == 0, "TRACE_LOG_LEN must be a power of two");
+
+// 記録種別（0〜2 は EventType と同値）
+enum class TraceKind : uint8_t {
+  IntFall     = 0,    // code = IntOutcome
+  ResetRise   = 1,
+  ResetFall   = 2,
+  Boot        = 0x80, // code = esp_reset_reason()
+  KillRelease = 0x81, // code = TraceRelease（supervisor_event.h）
+  Failsafe    = 0x82, // code = FailsafeReason（failsafe.h、上位4bitはチャネル番号、0xFはチャネルに依らない）
+};
+static_assert(static_cast<uint8_t>(TraceKind::IntFall)   == static_cast<uint8_t>(EventType::IntFall) &&
+              static_cast<uint8_t>(TraceKind::ResetRise) == static_cast<uint8_t>(EventType::ResetRise) &&
+              static_cast<uint8_t>(TraceKind::ResetFall) == static_cast<uint8_t>(EventType::ResetFall),
+              "TraceKind must mirror EventType");
+
+struct TraceRecord {
+  uint32_t atUs;   // 起動からの µs（下位32bit、Boot記録で区切る）
+  uint8_t  kind;   // TraceKind
+  uint8_t  code;   // 理由（チャネル別の記録は上位4bitがチャネル番号）
+  uint16_t seq;    // 書き込み通番の下位16bit（抜け検出用）
+};
+static_assert(sizeof(TraceRecord) == 8, "TraceRecord must stay 8 bytes (binary dump format)");
+
+struct TraceLog {
+  uint32_t    magic;    // 電源投入直後のゴミと区別する
+  uint32_t    written;  // 書き込み総数（次の書き込み位置 = written % TRACE_LOG_LEN）
+  uint32_t    boots;    // traceBegin() の回数
+  TraceRecord records[TRACE_LOG_LEN];
+};
+
+#if !SUPERVISOR_NATIVE
+extern TraceLog     g_trace;
+extern portMUX_TYPE g_traceMux;
+
+// 1件記録（ISR/タイマ/タスクのどこからでも可）
+inline void IRAM_ATTR traceWrite(uint64_t atUs, TraceKind kind, uint8_t code) {
+  portENTER_CRITICAL_SAFE(&g_traceMux);
+  uint32_t n = g_trace.written;
+  TraceRecord& r = g_trace.records[n & (TRACE_LOG_LEN - 1)];
+  r.atUs = static_cast<uint32_t>(atUs);
+  r.kind = static_cast<uint8_t>(kind);
+  r.code = code;
+  r.seq  = static_cast<uint16_t>(n);
+  g_trace.written = n + 1;
+  portEXIT_CRITICAL_SAFE(&g_traceMux);
+}
+#endif
+
+// 起動時: 内容が無効なら初期化し、Boot記録を追加
+void traceBegin();
+// 古い順にバイナリで書き出す（形式は trace_log.cpp 参照）
+void traceDump(Print& out);
+// 全消去
+void traceClear();
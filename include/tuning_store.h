@@ -0,0 +1,18 @@
+#pragma once
+#include <stdint.h>
+#include <Arduino.h>
+#include "supervisor_tuning.h"
+
+//==================== 設定の保存（NVS） ====================
+// 名前空間 "supervisor"、キー "tN"（N: チャネル番号）に版数つきで SupervisorTuning を置く。
+// 読み書きはフラッシュ操作を伴うので監視開始（arm）の後、loopタスクからのみ呼ぶ
+// （ULP監視モードだけは例外で、ULPを起動する前の setup() から1回読む）。
+
+// 保存値があれば out に入れて true（版数・サイズ不一致は無いものとして扱う）
+bool tuningLoad(uint8_t channel, SupervisorTuning& out);
+bool tuningSave(uint8_t channel, const SupervisorTuning& t);
+void tuningErase(uint8_t channel);
+
+// シリアル用: "ch=N hold_us=... " の1行出力、名前でフィールドを書き換え（未知の名前なら false）
+void tuningPrintLine(Print& out, uint8_t channel, const SupervisorTuning& t);
+bool tuningSetField(SupervisorTuning& t, const char* name, uint32_t value);
@@ -0,0 +1,55 @@
+#pragma once
+#include <stdint.h>
+#include <esp_err.h>
+
+//==================== ULP監視モード ====================
+// 1: INT/RESET/KILL の判定をULP(FSM)で行い、メインCPUはディープスリープ
+//    （LED表示とログの時だけ起床する最低消費電力SKU向け）
+#ifndef SUPERVISOR_ULP_MODE
+  #define SUPERVISOR_ULP_MODE 0
+#endif
+
+// ULP→メインCPU 通知ビット（ULP_VAR_EVENTS）
+constexpr uint32_t ULP_EVT_RESET_RISE  = 1u << 0;
+constexpr uint32_t ULP_EVT_RESET_FALL  = 1u << 1;
+constexpr uint32_t ULP_EVT_KILL        = 1u << 2;
+constexpr uint32_t ULP_EVT_KILL_RELEASE = 1u << 3;
+// メインCPUを起こすのはLED表示が必要なものだけ（KILL系は次回起床時にログ）
+constexpr uint32_t ULP_EVT_WAKE_MASK   = ULP_EVT_RESET_RISE | ULP_EVT_RESET_FALL;
+
+// RTC_SLOW_MEM 先頭に置く共有状態（メイン側 g_* の写し、時間はULPティック単位）
+// ULPは各ワードの下位16bitのみ読み書きする
+struct UlpSharedState {
+  uint32_t resetHighTicks;  // g_resetHighSinceUs 相当: RESET=H継続ティック+1（0ならL）
+  uint32_t lastReset;       // g_lastReset
+  uint32_t lastInt;         // 前回のINTレベル（立下り検出用）
+  uint32_t intDebounce;     // INTデバウンスの残りティック
+  uint32_t startupInhibit;  // g_startupInhibit 相当: 抑止の残りティック（0なら解除）
+  uint32_t killActive;      // g_killActive
+  uint32_t killTicks;       // g_killAssertAtUs 相当: アサートからの経過ティック
+  uint32_t events;          // ULP_EVT_* の累積（メインCPUが読んでクリア）
+};
+
+// 判定パラメータ（メイン側の実行時設定 SupervisorTuning の µs をティックへ換算して渡す）
+struct UlpConfig {
+  int      pinReset;
+  int      pinInt;
+  int      pinKill;
+  bool     killActiveLow;   // Config::KILL_ACTIVE_LOW（出力ラッチとアイドル側のプル）
+  uint32_t tickUs;
+  uint16_t intDebounceTicks;
+  uint16_t resetHighMinTicks;
+  uint16_t startupInhibitTicks;
+  uint16_t killMinHoldTicks;
+  uint16_t killTimeoutTicks;
+};
+
+// コールドブート時: RTC GPIOとULPプログラムを初期化して起動。
+// 失敗したらピンを通常のGPIOへ戻してエラーを返す（呼び出し側はメインCPUでの監視に切り替える）
+esp_err_t ulpSupervisorInit(const UlpConfig& cfg);
+// ULP起床時: 溜まった通知ビットを取り出してクリア
+uint32_t ulpSupervisorTakeEvents();
+// 共有状態の参照（ログ用）
+const volatile UlpSharedState& ulpSupervisorState();
+// ULP起床を有効にしてディープスリープ（戻らない）
+[[noreturn]] void ulpSupervisorSleep();
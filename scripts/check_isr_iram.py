@@ -0,0 +1,200 @@
+# ISR経路がフラッシュ上のコード・定数を使っていないかをビルド後に検証する
+#
+# ELFの .iram0.text を逆アセンブルし、ISR_ROOTS から直接呼び出し(call0/4/8/12)で
+# 到達できる関数がすべて IRAM か ROM にあることを確認する。フラッシュ(0x42000000〜)
+# 上の関数を呼んでいれば呼び出し経路を表示してビルドを失敗させる。
+# 到達した関数のリテラル(l32r で読む定数)がフラッシュのデータ(.rodata、DROM)を指していれば
+# 同じく失敗させる（switch のジャンプテーブル、フラッシュに置かれた const テーブルや文字列）。
+# ビルド設定で必須のエントリが .iram0.text に無い（IRAM_ATTR が外れた）場合も失敗させる。
+#
+# 追跡できないもの（警告のみ、または対象外）:
+#   - 関数ポインタ経由(callx*)の呼び出し先（警告）
+#   - リテラルがフラッシュ上の関数を指す場合（コールバックの登録などでも起きるので警告）
+#   - パニック経路(ALLOWED)を呼ぶ関数のDROM参照（assert のファイル名などとみなして警告）
+#   - DRAM上のポインタ・テーブルを経由した間接的なDROM参照（対象外）
+
+Import("env")  # noqa: F821  (PlatformIO SCons)
+
+import re
+import subprocess
+
+# ISRとして登録するエントリ（デマングル後の名前の先頭一致、またはクラスメンバ
+# "SupervisorSet<...>::onGpioInterrupt(void*)" のような "::名前(" で一致）
+ISR_ROOTS = ("onGpioInterrupt(", "onEdgeCapture(", "onBackstop(")
+# extern "C" のエントリ（objdump -C でも引数リストが付かないので名前の完全一致）
+ISR_C_ROOTS = ("esp_task_wdt_isr_user_handler",)
+
+# ビルド設定毎に必須のエントリ（既定値はヘッダの #ifndef と同じ）
+#   onGpioInterrupt : EDGE_CAPTURE_MCPWM 以外（共通GPIO割り込み）
+#   onEdgeCapture   : EDGE_CAPTURE_MCPWM（MCPWMキャプチャ割り込み）
+#   onBackstop / esp_task_wdt_isr_user_handler : SUPERVISOR_WATCHDOG（フェイルセーフ）
+REQUIRED_ROOTS = (
+    ("onGpioInterrupt(", lambda f: not f("EDGE_CAPTURE_MCPWM", False)),
+    ("onEdgeCapture(", lambda f: f("EDGE_CAPTURE_MCPWM", False)),
+    ("onBackstop(", lambda f: f("SUPERVISOR_WATCHDOG", True)),
+    ("esp_task_wdt_isr_user_handler", lambda f: f("SUPERVISOR_WATCHDOG", True)),
+)
+
+
+def _is_root(name):
+    return (name in ISR_C_ROOTS or name.startswith(ISR_ROOTS) or
+            any("::" + r in name for r in ISR_ROOTS))
+
+
+def _matches_root(name, root):
+    return name == root or name.startswith(root) or ("::" + root) in name
+
+# ESP32-S3 のアドレス範囲
+IRAM_RANGE = (0x40370000, 0x403E0000)
+ROM_RANGE = (0x40000000, 0x40060000)
+DROM_RANGE = (0x3C000000, 0x3E000000)  # フラッシュのデータ（キャッシュ経由）
+IROM_RANGE = (0x42000000, 0x44000000)  # フラッシュのコード（キャッシュ経由）
+
+# 戻らないパニック経路は許容（到達時点で既に異常系）
+ALLOWED = ("abort", "__assert_func", "esp_system_abort", "_esp_error_check_failed")
+
+FUNC_RE = re.compile(r"^([0-9a-f]+) <(.+)>:$")
+CALL_RE = re.compile(r"\s(call(?:0|4|8|12))\s+([0-9a-f]+)\s+<(.+?)(?:\+0x[0-9a-f]+)?>")
+CALLX_RE = re.compile(r"\scallx(?:0|4|8|12)\s")
+L32R_RE = re.compile(r"\sl32r\s+a\d+,\s*([0-9a-f]+)")
+DUMP_RE = re.compile(r"^ ([0-9a-f]{8}) ((?:[0-9a-f]{2,8} ){1,4})")
+
+
+def _in(addr, rng):
+    return rng[0] <= addr < rng[1]
+
+
+def _defines(env):
+    out = {}
+    for d in env.get("CPPDEFINES", []):
+        if isinstance(d, (tuple, list)):
+            out[str(d[0])] = str(d[1]) if len(d) > 1 else "1"
+        else:
+            out[str(d)] = "1"
+    return out
+
+
+def _flag_reader(defines):
+    def flag(name, default):
+        value = defines.get(name)
+        if value is None:
+            return default
+        try:
+            return int(value, 0) != 0
+        except ValueError:
+            return True
+    return flag
+
+
+def _disassemble(objdump, elf):
+    out = subprocess.run(
+        [objdump, "-d", "-C", "-j", ".iram0.text", elf],
+        check=True, capture_output=True, text=True,
+    ).stdout
+    funcs = {}      # name -> {"calls": [(addr, name)], "callx": bool, "literals": [addr]}
+    current = None
+    for line in out.splitlines():
+        m = FUNC_RE.match(line)
+        if m:
+            current = m.group(2)
+            funcs[current] = {"calls": [], "callx": False, "literals": []}
+            continue
+        if current is None:
+            continue
+        f = funcs[current]
+        c = CALL_RE.search(line)
+        if c:
+            f["calls"].append((int(c.group(2), 16), c.group(3)))
+            continue
+        if CALLX_RE.search(line):
+            f["callx"] = True
+            continue
+        r = L32R_RE.search(line)
+        if r:
+            f["literals"].append(int(r.group(1), 16))
+    return funcs
+
+
+# .iram0.text の内容（リテラルプールの値を読む）: 先頭アドレスと bytes
+def _section_bytes(objdump, elf):
+    out = subprocess.run(
+        [objdump, "-s", "-j", ".iram0.text", elf],
+        check=True, capture_output=True, text=True,
+    ).stdout
+    base, data = None, bytearray()
+    for line in out.splitlines():
+        m = DUMP_RE.match(line)
+        if not m:
+            continue
+        if base is None:
+            base = int(m.group(1), 16)
+        data += bytes.fromhex(m.group(2).replace(" ", ""))
+    return base, bytes(data)
+
+
+def _literal(base, data, addr):
+    if base is None or not (base <= addr and addr + 4 <= base + len(data)):
+        return None
+    return int.from_bytes(data[addr - base:addr - base + 4], "little")
+
+
+def check_isr_iram(source, target, env):
+    elf = str(target[0])
+    objdump = env.subst("$OBJCOPY").replace("objcopy", "objdump")
+    funcs = _disassemble(objdump, elf)
+    base, data = _section_bytes(objdump, elf)
+    flag = _flag_reader(_defines(env))
+
+    roots = [n for n in funcs if _is_root(n)]
+    errors, warnings = [], []
+    # ビルド設定で必須なのに .iram0.text に無い（IRAM_ATTR が外れてフラッシュへ置かれた等）
+    for root, required in REQUIRED_ROOTS:
+        present = any(_matches_root(n, root) for n in roots)
+        if required(flag) and not present:
+            errors.append("required ISR root %s not in .iram0.text (missing IRAM_ATTR?)" % root.rstrip("("))
+        elif not present:
+            print("check_isr_iram: note: root %s not in .iram0.text (not used by this build)" % root.rstrip("("))
+
+    seen = set()
+    stack = [(r, (r,)) for r in roots]
+    while stack:
+        name, path = stack.pop()
+        if name in seen:
+            continue
+        seen.add(name)
+        f = funcs[name]
+        if f["callx"]:
+            warnings.append(" -> ".join(path) + " (indirect call)")
+        panics = any(callee.startswith(ALLOWED) for _, callee in f["calls"])
+        for lit in f["literals"]:
+            value = _literal(base, data, lit)
+            if value is None:
+                continue
+            where = " -> ".join(path) + " loads 0x%08x (literal @0x%08x)" % (value, lit)
+            if _in(value, DROM_RANGE):
+                if panics:
+                    warnings.append(where + " (flash data, panic path)")
+                else:
+                    errors.append("flash-resident data in ISR path: " + where)
+            elif _in(value, IROM_RANGE):
+                warnings.append(where + " (flash code address)")
+        for addr, callee in f["calls"]:
+            if callee.startswith(ALLOWED) or _in(addr, ROM_RANGE):
+                continue
+            if not _in(addr, IRAM_RANGE):
+                errors.append("flash-resident call in ISR path: " +
+                              " -> ".join(path + (callee,)) + " @0x%08x" % addr)
+            elif callee in funcs:
+                stack.append((callee, path + (callee,)))
+
+    for w in sorted(set(warnings)):
+        print("check_isr_iram: warning: " + w)
+    if errors:
+        for e in sorted(set(errors)):
+            print("check_isr_iram: error: " + e)
+        env.Exit(1)
+    print("check_isr_iram: %d ISR roots, %d functions checked, all IRAM/ROM resident"
+          % (len(roots), len(seen)))
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", check_isr_iram)  # noqa: F821
@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+# 波形リプレイの入力（include/replay_format.h）を作り、実機へ流し込む
+#
+#   encode: ロジアナのCSV（時刻[s], RESET, INT の3列、先頭行が見出しでも可）をエッジ列に変換
+#           python3 scripts/replay_send.py encode capture.csv capture.rpl
+#   send  : エッジ列を SUPERVISOR_REPLAY のファームへクレジット制で送り、判定結果を表示
+#           python3 scripts/replay_send.py send capture.rpl /dev/ttyACM0
+# ホストのみで確かめる時は env:native のプログラムへ --replay capture.rpl で渡す。
+# CSVは1行ずつ、エッジ列は少しずつ読むので、長時間の記録でも全体をメモリに載せない。
+
+import argparse
+import csv
+import struct
+import sys
+
+MAGIC = b"RPL1"
+SIGNAL_RESET = 0
+SIGNAL_INT = 1
+SIGNAL_GAP = 0xFF
+MAX_DELTA_US = 0xFFFFFFFF
+RECORD = struct.Struct("<IBB")
+
+
+def _samples(path):
+    with open(path, newline="") as f:
+        for row in csv.reader(f):
+            if len(row) < 3:
+                continue
+            try:
+                yield float(row[0]), int(float(row[1])) != 0, int(float(row[2])) != 0
+            except ValueError:
+                continue  # 見出し行
+
+
+def encode(src, dst):
+    edges = 0
+    with open(dst, "wb") as out:
+        out.write(MAGIC)
+        last_us = None
+        levels = None
+        for t, reset, intr in _samples(src):
+            t_us = int(round(t * 1e6))
+            if levels is None:
+                # 先頭のレベルを時刻0のエッジとして出す（ファーム側の初期値は RESET=L / INT=H）
+                last_us, levels = t_us, (False, True)
+            for signal, now, prev in ((SIGNAL_RESET, reset, levels[0]), (SIGNAL_INT, intr, levels[1])):
+                if now == prev:
+                    continue
+                delta = t_us - last_us
+                while delta > MAX_DELTA_US:
+                    out.write(RECORD.pack(MAX_DELTA_US, SIGNAL_GAP, 0))
+                    delta -= MAX_DELTA_US
+                out.write(RECORD.pack(delta, signal, 1 if now else 0))
+                last_us = t_us
+                edges += 1
+            levels = (reset, intr)
+    print(f"encode: {edges} edges -> {dst}")
+
+
+def send(src, port, baud):
+    import serial  # pyserial
+
+    with serial.Serial(port, baud, timeout=0.05) as ser, open(src, "rb") as f:
+        credit = 0
+        sent_any = False
+        done_sending = False
+        line = b""
+        while True:
+            data = ser.read(256)
+            for b in data:
+                if b != 0x0A:
+                    line += bytes([b])
+                    continue
+                text = line.decode(errors="replace").strip()
+                line = b""
+                if not text.startswith("replay "):
+                    continue
+                fields = dict(kv.split("=", 1) for kv in text.split()[1:] if "=" in kv)
+                if text.startswith("replay ready"):
+                    if not sent_any:
+                        credit = int(fields["credit"])  # 受信前の ready は繰り返されるので置き換える
+                    continue
+                if "credit" in fields:
+                    credit += int(fields["credit"])
+                    continue
+                print(text)
+                if text.startswith("replay done") or text.startswith("replay error"):
+                    return 0 if text.startswith("replay done") else 1
+            if not done_sending and credit > 0:
+                chunk = f.read(credit)
+                if not chunk:
+                    done_sending = True
+                else:
+                    ser.write(chunk)
+                    credit -= len(chunk)
+                    sent_any = True
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__)
+    sub = ap.add_subparsers(dest="cmd", required=True)
+    e = sub.add_parser("encode")
+    e.add_argument("csv")
+    e.add_argument("out")
+    s = sub.add_parser("send")
+    s.add_argument("file")
+    s.add_argument("port")
+    s.add_argument("--baud", type=int, default=115200)
+    args = ap.parse_args()
+    if args.cmd == "encode":
+        encode(args.csv, args.out)
+        return 0
+    return send(args.file, args.port, args.baud)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+# SUPERVISOR_TELEMETRY のファームが送るフレーム（include/telemetry.h）を受けて記録を表示する
+#
+#   python3 scripts/telemetry_recv.py /dev/ttyACM0            （1記録1行のテキスト）
+#   python3 scripts/telemetry_recv.py /dev/ttyACM0 --raw log.bin （検査済みのフレームをそのまま追記）
+# 0x00 区切りで COBS を解き、CRC不一致（コマンド応答のテキストが挟まった断片など）は捨てる。
+# firstIndex が前のフレームの続きでなければ取りこぼしとして "lost" を出す。
+
+import argparse
+import struct
+import sys
+import zlib
+
+MAGIC = b"TLM1"
+HEADER = struct.Struct("<4sHHII")
+RECORD = struct.Struct("<IBBH")
+KIND_NAMES = {0: "int_fall", 1: "reset_rise", 2: "reset_fall", 0x80: "boot", 0x81: "kill_release", 0x82: "failsafe"}
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def parse(frame):
+    if len(frame) < HEADER.size + 4:
+        return None
+    body, crc = frame[:-4], struct.unpack("<I", frame[-4:])[0]
+    if zlib.crc32(body) != crc:
+        return None
+    magic, seq, count, first, boots = HEADER.unpack_from(body)
+    if magic != MAGIC or len(body) != HEADER.size + count * RECORD.size:
+        return None
+    records = [RECORD.unpack_from(body, HEADER.size + i * RECORD.size) for i in range(count)]
+    return seq, first, boots, records
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__)
+    ap.add_argument("port")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--raw", help="検査済みのフレーム（COBS符号化前）を追記するファイル")
+    args = ap.parse_args()
+
+    import serial  # pyserial
+
+    raw = open(args.raw, "ab") if args.raw else None
+    next_index = None
+    buf = bytearray()
+    with serial.Serial(args.port, args.baud, timeout=0.2) as ser:
+        while True:
+            buf += ser.read(4096)
+            while True:
+                end = buf.find(b"\x00")
+                if end < 0:
+                    break
+                chunk, buf = bytes(buf[:end]), buf[end + 1:]
+                if not chunk:
+                    continue
+                frame = cobs_decode(chunk)
+                parsed = parse(frame) if frame is not None else None
+                if parsed is None:
+                    continue
+                seq, first, boots, records = parsed
+                if raw:
+                    raw.write(frame)
+                    raw.flush()
+                if next_index is not None and first > next_index:
+                    print(f"lost records={first - next_index} frame={seq}")
+                next_index = first + len(records)
+                for i, (at_us, kind, code, _) in enumerate(records):
+                    name = KIND_NAMES.get(kind, f"kind{kind:#04x}")
+                    print(f"{first + i} boots={boots} at_us={at_us} {name} code={code:#04x}")
+                sys.stdout.flush()
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,269 @@
+#include "bench.h"
+
+#if SUPERVISOR_BENCH
+
+#include <Arduino.h>
+#include <algorithm>
+#include <esp_cpu.h>
+#include <esp_timer.h>
+#include "cpu_dfs.h"
+#include <soc/gpio_struct.h>
+#include "supervisor_config.h"
+#if BENCH_WIFI_LOAD
+  #include <WiFi.h>
+  #include <esp_wifi.h>
+#endif
+
+namespace {
+
+constexpr BaseType_t  BENCH_CORE  = 0;    // 監視タスク（SUPERVISOR_CORE=1）と別コア
+constexpr UBaseType_t BENCH_PRIO  = 1;
+constexpr uint32_t    BENCH_STACK = 4096;
+// 応答を割り込み禁止で待つ上限。超えたら割り込みを戻して待ち続け、その回は slow として別に数える
+// （抑止・RESET継続不足などでKILLしない回に、core 0 の esp_timer・フェイルセーフ・無線を止めない）
+constexpr uint32_t    BENCH_MASKED_US = 300;
+constexpr uint32_t    BENCH_YIELD_US  = 5000; // 割り込み許可後、これを過ぎたら1tickずつ譲る（IDLE0のWDT）
+
+BenchConfig g_cfg;
+uint32_t*   g_intToKillCycles = nullptr;   // 1サイクル1サンプル（benchTicks() の差）
+uint32_t*   g_resetToReleaseCycles = nullptr;
+
+// 応答計測の時計: 通常はCPUサイクル、SUPERVISOR_DFS では計測中にCPU周波数が変わるので
+// 固定クロックの esp_timer[µs]（分解能1µs、周波数切り替えの遅延を含めて計る）
+#if SUPERVISOR_DFS
+inline uint32_t benchTicks() { return static_cast<uint32_t>(esp_timer_get_time()); }
+inline uint32_t benchTicksPerUs() { return 1; }
+#else
+inline uint32_t benchTicks() { return esp_cpu_get_ccount(); }
+inline uint32_t benchTicksPerUs() { return getCpuFrequencyMhz(); }
+#endif
+
+inline void drive(int pin, bool high) {
+  if (high) GPIO.out_w1ts = 1u << pin;
+  else      GPIO.out_w1tc = 1u << pin;
+}
+
+inline bool padHigh(int pin) {
+  return ((GPIO.in >> pin) & 1u) != 0;
+}
+
+// ピンを駆動してから pinKill が want になるまでの benchTicks() 数（タイムアウトなら UINT32_MAX）
+// 最初の BENCH_MASKED_US だけこのコアの割り込みを止めて計測側の揺らぎを除く。
+// それを超えた回（maskedTicks 以上の値、report() で slow）は割り込みを許可して待つ。
+// その待ちとタイムアウトは esp_timer[µs] で数える（CPUサイクルは240MHzで約17.9秒で一周するが、
+// 実行時設定のタイムアウトは最大60秒）。一周を超えた回は UINT32_MAX - 1 に丸める
+uint32_t stimulusToKill(int drvPin, bool drvLevel, bool want, uint32_t maskedTicks, uint32_t timeoutUs) {
+  portDISABLE_INTERRUPTS();
+  const int64_t startUs = esp_timer_get_time();
+  const uint32_t start = benchTicks();
+  drive(drvPin, drvLevel);
+  uint32_t elapsed = 0;
+  while (padHigh(g_cfg.pinKill) != want && elapsed < maskedTicks) {
+    elapsed = benchTicks() - start;
+  }
+  if (elapsed < maskedTicks) {
+    elapsed = benchTicks() - start;
+    portENABLE_INTERRUPTS();
+    return elapsed;
+  }
+  portENABLE_INTERRUPTS();
+
+  while (padHigh(g_cfg.pinKill) != want) {
+    const int64_t waitedUs = esp_timer_get_time() - startUs;
+    if (waitedUs >= static_cast<int64_t>(timeoutUs)) return UINT32_MAX;
+    if (waitedUs >= BENCH_YIELD_US) vTaskDelay(1);
+  }
+  const uint64_t ticks = static_cast<uint64_t>(esp_timer_get_time() - startUs) * benchTicksPerUs();
+  return ticks < UINT32_MAX ? static_cast<uint32_t>(ticks) : UINT32_MAX - 1;
+}
+
+//==================== 無線負荷（BENCH_WIFI_LOAD） ====================
+#if BENCH_WIFI_LOAD
+constexpr UBaseType_t WIFI_LOAD_PRIO  = BENCH_PRIO; // 計測タスクとラウンドロビン（送信キューが満杯なら待つ）
+constexpr uint32_t    WIFI_LOAD_STACK = 3072;
+constexpr size_t      WIFI_LOAD_FRAME_LEN = 24 + 8 + 1400; // ヘッダ + LLC/SNAP + ペイロード
+
+volatile uint32_t g_wifiFrames = 0;
+volatile uint32_t g_wifiBusy   = 0; // 送信キュー満杯で待った回数
+volatile bool     g_wifiStop   = false;
+
+// 自局BSSIDからブロードキャストへのデータフレーム（FromDS、LLC/SNAPの後は0埋め）
+void wifiLoadTask(void*) {
+  static uint8_t frame[WIFI_LOAD_FRAME_LEN];
+  uint8_t mac[6];
+  esp_wifi_get_mac(WIFI_IF_AP, mac);
+  memset(frame, 0, sizeof(frame));
+  frame[0] = 0x08;                 // type=data
+  frame[1] = 0x02;                 // FromDS
+  memset(frame + 4, 0xFF, 6);      // addr1 = DA（ブロードキャスト）
+  memcpy(frame + 10, mac, 6);      // addr2 = BSSID
+  memcpy(frame + 16, mac, 6);      // addr3 = SA
+  const uint8_t snap[8] = {0xAA, 0xAA, 0x03, 0x00, 0x00, 0x00, 0x88, 0xB5}; // 実験用EtherType
+  memcpy(frame + 24, snap, sizeof(snap));
+  while (!g_wifiStop) {
+    if (esp_wifi_80211_tx(WIFI_IF_AP, frame, sizeof(frame), true) == ESP_OK) {
+      g_wifiFrames = g_wifiFrames + 1;
+    } else {
+      g_wifiBusy = g_wifiBusy + 1;
+      vTaskDelay(1);
+    }
+  }
+  vTaskDelete(nullptr);
+}
+
+void wifiLoadBegin() {
+  WiFi.mode(WIFI_AP);
+  WiFi.softAP("tps3424-bench", nullptr, BENCH_WIFI_CHANNEL);
+  xTaskCreatePinnedToCore(wifiLoadTask, "wifi_load", WIFI_LOAD_STACK, nullptr,
+                          WIFI_LOAD_PRIO, nullptr, BENCH_CORE);
+}
+
+void wifiLoadEnd(uint32_t elapsedMs) {
+  g_wifiStop = true;
+  Serial.printf("bench: wifi load ch=%u frames=%u (%.0f/s, %u B) queue_full=%u\n",
+                (unsigned)BENCH_WIFI_CHANNEL, (unsigned)g_wifiFrames,
+                elapsedMs > 0 ? g_wifiFrames * 1000.0 / elapsedMs : 0.0,
+                (unsigned)WIFI_LOAD_FRAME_LEN,
+                (unsigned)g_wifiBusy);
+}
+#endif
+
+inline void waitUs(uint32_t us) {
+  vTaskDelay(pdMS_TO_TICKS((us + 999) / 1000) + 1);
+}
+
+// 分布の要約とlog2(µs)ヒストグラムを出力（samples はソートされる）
+// 割り込み禁止の窓（maskedTicks）を超えた回は割り込み込みの値なので分布から外し、件数と最大だけ出す
+void report(const char* name, uint32_t* samples, uint32_t n, uint32_t cyclesPerUs, uint32_t maskedTicks) {
+  uint32_t valid = 0, slow = 0, slowMax = 0;
+  for (uint32_t i = 0; i < n; ++i) {
+    if (samples[i] == UINT32_MAX) continue;
+    if (samples[i] >= maskedTicks) {
+      ++slow;
+      slowMax = std::max(slowMax, samples[i]);
+      continue;
+    }
+    samples[valid++] = samples[i];
+  }
+  uint32_t timeouts = n - valid - slow;
+  auto us = [cyclesPerUs](uint32_t c) { return static_cast<double>(c) / cyclesPerUs; };
+  if (valid == 0) {
+    Serial.printf("%-16s n=0 timeouts=%u slow=%u slow_max=%.0fus\n", name, (unsigned)timeouts,
+                  (unsigned)slow, us(slowMax));
+    return;
+  }
+  std::sort(samples, samples + valid);
+  Serial.printf("%-16s n=%u timeouts=%u slow=%u min=%.2fus med=%.2fus p99=%.2fus max=%.2fus",
+                name, (unsigned)valid, (unsigned)timeouts, (unsigned)slow,
+                us(samples[0]), us(samples[valid / 2]),
+                us(samples[(valid * 99) / 100]), us(samples[valid - 1]));
+  if (slow > 0) Serial.printf(" slow_max=%.0fus", us(slowMax));
+  Serial.print("\n");
+
+  constexpr int BUCKETS = 16; // [0,1) [1,2) [2,4) ... [2^14, ∞) µs
+  uint32_t hist[BUCKETS] = {};
+  for (uint32_t i = 0; i < valid; ++i) {
+    uint32_t v = samples[i] / cyclesPerUs;
+    int b = 0;
+    while (v && b < BUCKETS - 1) { v >>= 1; ++b; }
+    ++hist[b];
+  }
+  for (int b = 0; b < BUCKETS; ++b) {
+    if (hist[b] == 0) continue;
+    uint32_t lo = b == 0 ? 0 : (1u << (b - 1));
+    Serial.printf("  %6uus- : %u\n", (unsigned)lo, (unsigned)hist[b]);
+  }
+}
+
+// GPIO操作1回あたりのCPUサイクル（HAL経由とレジスタ直の比較、割り込み禁止で平均）
+constexpr uint32_t MICRO_ITERATIONS = 1000;
+
+template <typename Op>
+uint32_t cyclesPerOp(Op op) {
+  portDISABLE_INTERRUPTS();
+  uint32_t start = esp_cpu_get_ccount();
+  for (uint32_t i = 0; i < MICRO_ITERATIONS; ++i) op(i);
+  uint32_t elapsed = esp_cpu_get_ccount() - start;
+  portENABLE_INTERRUPTS();
+  return elapsed / MICRO_ITERATIONS;
+}
+
+void microBench() {
+  const int kill = g_cfg.pinKill;
+  volatile uint32_t sink = 0;
+  Serial.printf("gpio read   : digitalRead %u cyc, GPIO.in %u cyc\n",
+                (unsigned)cyclesPerOp([&](uint32_t) { sink = sink + digitalRead(kill); }),
+                (unsigned)cyclesPerOp([&](uint32_t) { sink = sink + padHigh(kill); }));
+  if (g_cfg.pinScratch < 0) return;
+
+  // KILLと同じオープンドレイン相当（ラッチL固定、出力有効/無効の切り替え）を予備ピンで
+  const int pin = g_cfg.pinScratch;
+  const uint32_t mask = 1u << pin;
+  pinMode(pin, INPUT_PULLUP);
+  GPIO.out_w1tc = mask;
+  Serial.printf("gpio toggle : pinMode %u cyc, GPIO.enable_w1ts/w1tc %u cyc\n",
+                (unsigned)cyclesPerOp([&](uint32_t i) { pinMode(pin, (i & 1) ? INPUT_PULLUP : OUTPUT); }),
+                (unsigned)cyclesPerOp([&](uint32_t i) {
+                  if (i & 1) GPIO.enable_w1tc = mask;
+                  else       GPIO.enable_w1ts = mask;
+                }));
+  pinMode(pin, INPUT_PULLUP);
+}
+
+// 1サイクル: RESET↑ → 待機 → INT↓でKILL↓を計測 → INT↑ → 保持待ち → RESET↓でKILL↑を計測
+void benchTask(void*) {
+  const uint32_t cyclesPerUs   = benchTicksPerUs();
+  const uint32_t maskedTicks   = BENCH_MASKED_US * cyclesPerUs;
+
+  drive(g_cfg.drvInt, true);
+  drive(g_cfg.drvReset, false);
+  waitUs(g_cfg.cycleGapUs);
+  Serial.printf("bench: %u cycles, cpu %u MHz\n", (unsigned)g_cfg.cycles, (unsigned)getCpuFrequencyMhz());
+#if SUPERVISOR_DFS
+  Serial.printf("bench: dfs %u-%u MHz, latency in esp_timer us\n", (unsigned)DFS_MIN_MHZ, (unsigned)DFS_MAX_MHZ);
+#endif
+  Serial.printf("bench: coex=%u wifi_load=%u\n", (unsigned)SUPERVISOR_COEX, (unsigned)BENCH_WIFI_LOAD);
+  microBench();
+#if BENCH_WIFI_LOAD
+  wifiLoadBegin();
+  const uint32_t loadStartMs = millis();
+#endif
+
+  for (uint32_t i = 0; i < g_cfg.cycles; ++i) {
+    drive(g_cfg.drvReset, true);
+    waitUs(g_cfg.resetSettleUs);
+
+    g_intToKillCycles[i] = stimulusToKill(g_cfg.drvInt, false, false, maskedTicks, g_cfg.timeoutUs);
+    drive(g_cfg.drvInt, true);
+    waitUs(g_cfg.killHoldUs);
+
+    g_resetToReleaseCycles[i] = stimulusToKill(g_cfg.drvReset, false, true, maskedTicks, g_cfg.timeoutUs);
+    waitUs(g_cfg.cycleGapUs);
+  }
+
+#if BENCH_WIFI_LOAD
+  wifiLoadEnd(millis() - loadStartMs);
+#endif
+  report("INT->KILL",       g_intToKillCycles,      g_cfg.cycles, cyclesPerUs, maskedTicks);
+  report("RESET->RELEASE",  g_resetToReleaseCycles, g_cfg.cycles, cyclesPerUs, maskedTicks);
+  Serial.println("bench: done");
+  vTaskDelete(nullptr);
+}
+
+} // namespace
+
+void benchBegin(const BenchConfig& cfg) {
+  g_cfg = cfg;
+  g_intToKillCycles      = static_cast<uint32_t*>(malloc(cfg.cycles * sizeof(uint32_t)));
+  g_resetToReleaseCycles = static_cast<uint32_t*>(malloc(cfg.cycles * sizeof(uint32_t)));
+  if (!g_intToKillCycles || !g_resetToReleaseCycles) {
+    log_e("bench: out of memory for %u samples", (unsigned)cfg.cycles);
+    return;
+  }
+  pinMode(cfg.drvReset, OUTPUT);
+  pinMode(cfg.drvInt,   OUTPUT);
+  xTaskCreatePinnedToCore(benchTask, "bench", BENCH_STACK, nullptr,
+                          BENCH_PRIO, nullptr, BENCH_CORE);
+}
+
+#endif // SUPERVISOR_BENCH
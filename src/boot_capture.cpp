@@ -0,0 +1,103 @@
+#include "boot_capture.h"
+#include <esp_timer.h>
+#include <esp_private/esp_clk.h>
+#include <hal/pcnt_ll.h>
+#include <hal/clk_gate_ll.h>
+#include <soc/pcnt_periph.h>
+#include <soc/gpio_periph.h>
+#include <soc/io_mux_reg.h>
+#include <esp_rom_gpio.h>
+#include <esp_rom_sys.h>
+#include <soc/reset_reasons.h>
+
+constexpr uint32_t BOOT_CAPTURE_MAGIC = 0x31504342; // 送出順に "BCP1"
+
+RTC_NOINIT_ATTR BootCaptureState g_bootCapture;
+int64_t g_rtcOffsetUs = 0;
+
+namespace {
+
+BootKind g_bootKind = BootKind::Cold;
+
+// esp_reset_reason() に頼らず（初期化順に依存しないよう）ROMのリセット要因を直接読む。MCUの電源が落ちた要因だけを Cold とする
+BootKind classifyBoot(soc_reset_reason_t reason) {
+  switch (reason) {
+    case RESET_REASON_CHIP_POWER_ON:
+    case RESET_REASON_SYS_BROWN_OUT:
+    case RESET_REASON_CORE_PWR_GLITCH:
+      return BootKind::Cold;
+    default:
+      return BootKind::Warm;
+  }
+}
+
+} // namespace
+
+void bootCaptureBegin() {
+  const int64_t rtcNow = static_cast<int64_t>(esp_rtc_get_time_us());
+  g_rtcOffsetUs = rtcNow - esp_timer_get_time();
+  g_bootKind = classifyBoot(esp_rom_get_reset_reason(0));
+  if (g_bootCapture.magic != BOOT_CAPTURE_MAGIC || g_bootKind == BootKind::Cold) {
+    memset(&g_bootCapture, 0, sizeof(g_bootCapture));
+    g_bootCapture.magic = BOOT_CAPTURE_MAGIC;
+    return;
+  }
+  // RTCタイマより未来の記録はRTCタイマが戻った（チップリセット）後のもの
+  for (uint8_t ch = 0; ch < BOOT_CAPTURE_CHANNELS; ++ch) {
+    if (g_bootCapture.resetHighSinceRtcUs[ch] > rtcNow) g_bootCapture.resetHighSinceRtcUs[ch] = 0;
+  }
+}
+
+BootKind bootCaptureKind() {
+  return g_bootKind;
+}
+
+bool bootCaptureResetHighSince(uint8_t channel, usec_t& sinceUs) {
+  const int64_t rtcSince = g_bootCapture.resetHighSinceRtcUs[channel];
+  if (rtcSince == 0) return false;
+  sinceUs = rtcSince - g_rtcOffsetUs;
+  return true;
+}
+
+//==================== INT立下りの計数（PCNT） ====================
+// 静的初期化（SUPERVISOR_FAST_BOOT）からも呼ぶので、ドライバを使わずレジスタだけで構成する
+// （PCNTドライバの参照カウントは使わない。このファームウェアで他にPCNTを使う箇所はない）
+// グリッチフィルタはAPBクロックで最大1023サイクル（約12.8µs）
+constexpr uint16_t PCNT_FILTER_APB_CYCLES = 1023;
+
+namespace {
+bool g_intCounting[BOOT_CAPTURE_PCNT_UNITS] = {}; // 計数中（ゼロ初期化なので静的初期化の順序に依らない）
+} // namespace
+
+void bootCaptureIntBegin(uint8_t channel, int pin) {
+  if (channel >= BOOT_CAPTURE_PCNT_UNITS || g_intCounting[channel]) return;
+  const pcnt_unit_t unit = static_cast<pcnt_unit_t>(channel);
+  // INTのパッド: GPIO機能・入力有効・プルアップ（OD想定、正式な設定は後の pinMode()）
+  PIN_FUNC_SELECT(GPIO_PIN_MUX_REG[pin], PIN_FUNC_GPIO);
+  PIN_INPUT_ENABLE(GPIO_PIN_MUX_REG[pin]);
+  REG_CLR_BIT(GPIO_PIN_MUX_REG[pin], FUN_PD);
+  REG_SET_BIT(GPIO_PIN_MUX_REG[pin], FUN_PU);
+  esp_rom_gpio_connect_in_signal(pin, pcnt_periph_signals.groups[0].units[unit].channels[0].pulse_sig, false);
+
+  periph_ll_enable_clk_clear_rst(PERIPH_PCNT_MODULE);
+  pcnt_ll_set_mode(&PCNT, unit, PCNT_CHANNEL_0, PCNT_COUNT_DIS, PCNT_COUNT_INC, // 立下りのみ
+                   PCNT_MODE_KEEP, PCNT_MODE_KEEP);
+  pcnt_ll_set_event_value(&PCNT, unit, PCNT_EVT_H_LIM, INT16_MAX);
+  pcnt_ll_set_event_value(&PCNT, unit, PCNT_EVT_L_LIM, 0);
+  pcnt_ll_set_filter_value(&PCNT, unit, PCNT_FILTER_APB_CYCLES);
+  pcnt_ll_filter_enable(&PCNT, unit);
+  pcnt_ll_counter_clear(&PCNT, unit);
+  pcnt_ll_counter_resume(&PCNT, unit);
+  g_intCounting[channel] = true;
+}
+
+uint32_t bootCaptureIntTake(uint8_t channel) {
+  if (channel >= BOOT_CAPTURE_PCNT_UNITS || !g_intCounting[channel]) return 0;
+  const pcnt_unit_t unit = static_cast<pcnt_unit_t>(channel);
+  int16_t count = 0;
+  pcnt_ll_counter_pause(&PCNT, unit);
+  pcnt_ll_get_counter_value(&PCNT, unit, &count);
+  pcnt_ll_counter_clear(&PCNT, unit);
+  g_intCounting[channel] = false;
+  return count > 0 ? static_cast<uint32_t>(count) : 0;
+}
@@ -0,0 +1,39 @@
+#include "boot_profile.h"
+#include <esp_timer.h>
+#include <esp_private/esp_clk.h>
+#include <esp_system.h>
+#include "boot_capture.h"
+
+namespace {
+
+struct BootMark {
+  uint64_t rtcUs;  // 0なら未記録
+  int64_t  appUs;
+};
+
+BootMark g_marks[static_cast<size_t>(BootStage::Count)] = {};
+
+const char* const STAGE_NAMES[] = {"early", "setup", "armed"};
+static_assert(sizeof(STAGE_NAMES) / sizeof(STAGE_NAMES[0]) == static_cast<size_t>(BootStage::Count),
+              "STAGE_NAMES must match BootStage");
+
+} // namespace
+
+void bootMark(BootStage stage) {
+  BootMark& m = g_marks[static_cast<size_t>(stage)];
+  if (m.rtcUs != 0) return;
+  m.appUs = esp_timer_get_time();
+  m.rtcUs = esp_rtc_get_time_us();
+}
+
+void bootReport(Print& out) {
+  out.printf("boot kind=%s reason=%d", bootCaptureKind() == BootKind::Warm ? "warm" : "cold",
+             (int)esp_reset_reason());
+  for (size_t i = 0; i < static_cast<size_t>(BootStage::Count); ++i) {
+    const BootMark& m = g_marks[i];
+    if (m.rtcUs == 0) continue;
+    out.printf(" %s=rtc:%lluus/app:%lldus", STAGE_NAMES[i],
+               (unsigned long long)m.rtcUs, (long long)m.appUs);
+  }
+  out.println();
+}
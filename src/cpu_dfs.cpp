@@ -0,0 +1,82 @@
+#include "cpu_dfs.h"
+#include "supervisor_config.h"
+
+#if SUPERVISOR_DFS
+
+#if EDGE_CAPTURE_MCPWM && DFS_MIN_MHZ < 80
+  #error "EDGE_CAPTURE_MCPWM assumes an 80 MHz APB clock; keep DFS_MIN_MHZ at 80 or above"
+#endif
+
+esp_pm_lock_handle_t g_dfsLocks[static_cast<size_t>(DfsHold::Count)] = {};
+volatile bool        g_dfsEventHeld = false;
+DfsResidency         g_dfsResidency = {};
+portMUX_TYPE         g_dfsMux = portMUX_INITIALIZER_UNLOCKED;
+
+void dfsBegin() {
+  if (DFS_MARKER_PIN >= 0) {
+    pinMode(DFS_MARKER_PIN, OUTPUT);
+    digitalWrite(DFS_MARKER_PIN, LOW);
+  }
+  // 自動ライトスリープは使わない（LOW_POWER_MODE は起床時のエッジ合成のため自前で眠る）
+  const esp_pm_config_esp32s3_t cfg = {
+    .max_freq_mhz = DFS_MAX_MHZ,
+    .min_freq_mhz = DFS_MIN_MHZ,
+    .light_sleep_enable = false,
+  };
+  esp_err_t err = esp_pm_configure(&cfg);
+  if (err != ESP_OK) {
+    log_e("esp_pm_configure failed (%d), running at a fixed frequency", err);
+    return;
+  }
+  const char* const names[] = {"sv_event", "sv_kill", "sv_led"};
+  static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(DfsHold::Count),
+                "names must match DfsHold");
+  for (size_t i = 0; i < static_cast<size_t>(DfsHold::Count); ++i) {
+    ESP_ERROR_CHECK(esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, names[i], &g_dfsLocks[i]));
+  }
+}
+
+void dfsReport(Print& out) {
+  constexpr size_t N = static_cast<size_t>(DfsHold::Count);
+  portENTER_CRITICAL(&g_dfsMux);
+  const DfsResidency r = g_dfsResidency;
+  portEXIT_CRITICAL(&g_dfsMux);
+  const int64_t now = nowUs();
+  uint64_t held[N];
+  for (size_t i = 0; i < N; ++i) held[i] = r.heldUs[i] + (r.depth[i] > 0 ? now - r.sinceUs[i] : 0);
+  const uint64_t boosted = r.boostedUs + (r.anyDepth > 0 ? now - r.anySinceUs : 0);
+  const uint64_t window  = static_cast<uint64_t>(now - r.clearedAtUs);
+  out.printf("dfs min_mhz=%u max_mhz=%u window_us=%llu boosted_us=%llu boost_ppm=%llu",
+             (unsigned)DFS_MIN_MHZ, (unsigned)DFS_MAX_MHZ, (unsigned long long)window,
+             (unsigned long long)boosted, (unsigned long long)(window > 0 ? boosted * 1000000ull / window : 0));
+  const char* const names[] = {"event", "kill", "led"};
+  static_assert(sizeof(names) / sizeof(names[0]) == N, "names must match DfsHold");
+  for (size_t i = 0; i < N; ++i) {
+    out.printf(" %s=%u/%lluus", names[i], (unsigned)r.acquires[i], (unsigned long long)held[i]);
+  }
+  out.print("\n");
+}
+
+void dfsClear() {
+  constexpr size_t N = static_cast<size_t>(DfsHold::Count);
+  portENTER_CRITICAL(&g_dfsMux);
+  DfsResidency& r = g_dfsResidency;
+  const int64_t now = nowUs();
+  for (size_t i = 0; i < N; ++i) {
+    r.acquires[i] = 0;
+    r.heldUs[i]   = 0;
+    if (r.depth[i] > 0) r.sinceUs[i] = now;
+  }
+  r.boostedUs = 0;
+  if (r.anyDepth > 0) r.anySinceUs = now;
+  r.clearedAtUs = now;
+  portEXIT_CRITICAL(&g_dfsMux);
+}
+
+#else
+
+void dfsBegin() {}
+void dfsReport(Print& out) { out.print("dfs disabled\n"); }
+void dfsClear() {}
+
+#endif // SUPERVISOR_DFS
@@ -0,0 +1,106 @@
+#include "failsafe.h"
+#include <string.h>
+#include <esp_timer.h>
+#include <esp_ipc.h>
+#include <esp_intr_alloc.h>
+#include <esp_task_wdt.h>
+#include <driver/timer.h>
+#include <soc/soc.h>
+#include "boot_capture.h"
+#include "trace_log.h"
+
+constexpr uint32_t FAILSAFE_MAGIC = 0x31534646; // 送出順に "FFS1"
+
+RTC_NOINIT_ATTR FailsafeRecord g_failsafe;
+
+namespace {
+
+// ハードウェアタイマ（Arduinoの timerBegin(3) と同じユニットなので併用しない）
+constexpr timer_group_t BACKSTOP_GROUP = TIMER_GROUP_1;
+constexpr timer_idx_t   BACKSTOP_TIMER = TIMER_1;
+constexpr uint32_t      BACKSTOP_DIVIDER = APB_CLK_FREQ / 1000000; // 1µs/カウント
+
+bool (*g_backstopIsr)(void*) = nullptr;
+void (*volatile g_watchdogHook)() = nullptr;
+
+const char* const REASON_NAMES[] = {"none", "backstop_release", "backstop_assert", "task_wdt"};
+
+#if SUPERVISOR_WATCHDOG
+// 割り込みの確保は確保したコアに紐づくので BACKSTOP_CORE 上で行う
+void backstopSetup(void*) {
+  timer_config_t cfg = {};
+  cfg.alarm_en    = TIMER_ALARM_EN;
+  cfg.counter_en  = TIMER_PAUSE;
+  cfg.intr_type   = TIMER_INTR_LEVEL;
+  cfg.counter_dir = TIMER_COUNT_UP;
+  cfg.auto_reload = TIMER_AUTORELOAD_EN;
+  cfg.divider     = BACKSTOP_DIVIDER;
+  ESP_ERROR_CHECK(timer_init(BACKSTOP_GROUP, BACKSTOP_TIMER, &cfg));
+  timer_set_counter_value(BACKSTOP_GROUP, BACKSTOP_TIMER, 0);
+  timer_set_alarm_value(BACKSTOP_GROUP, BACKSTOP_TIMER, BACKSTOP_PERIOD_US);
+  timer_enable_intr(BACKSTOP_GROUP, BACKSTOP_TIMER);
+  ESP_ERROR_CHECK(timer_isr_callback_add(BACKSTOP_GROUP, BACKSTOP_TIMER, g_backstopIsr, nullptr,
+                                         ESP_INTR_FLAG_IRAM));
+  timer_start(BACKSTOP_GROUP, BACKSTOP_TIMER);
+}
+#endif
+
+} // namespace
+
+// タスクウォッチドッグ割り込みからパニック直前に呼ばれる（IDFの弱シンボルを上書き）
+extern "C" void IRAM_ATTR esp_task_wdt_isr_user_handler(void) {
+  if (g_watchdogHook != nullptr) g_watchdogHook();
+  failsafeNote(FailsafeReason::TaskWatchdog, FAILSAFE_NO_CHANNEL);
+}
+
+void failsafeBegin() {
+  if (g_failsafe.magic != FAILSAFE_MAGIC || bootCaptureKind() == BootKind::Cold) {
+    memset(&g_failsafe, 0, sizeof(g_failsafe));
+    g_failsafe.magic       = FAILSAFE_MAGIC;
+    g_failsafe.lastChannel = FAILSAFE_NO_CHANNEL;
+  }
+}
+
+void IRAM_ATTR failsafeNote(FailsafeReason reason, uint8_t channel) {
+  const usec_t now = nowUs();
+  g_failsafe.count       = g_failsafe.count + 1;
+  g_failsafe.lastReason  = static_cast<uint8_t>(reason);
+  g_failsafe.lastChannel = channel;
+  g_failsafe.lastRtcUs   = g_rtcOffsetUs + now;
+  const uint8_t ch = channel == FAILSAFE_NO_CHANNEL ? 0x0F : channel;
+  traceWrite(now, TraceKind::Failsafe, static_cast<uint8_t>(static_cast<uint8_t>(reason) | (ch << 4)));
+}
+
+void failsafeBackstopBegin(bool (*isr)(void*)) {
+#if SUPERVISOR_WATCHDOG
+  g_backstopIsr = isr;
+  ESP_ERROR_CHECK(esp_ipc_call_blocking(BACKSTOP_CORE, backstopSetup, nullptr));
+#else
+  (void)isr;
+#endif
+}
+
+void failsafeWatchdogAdd(void (*hook)()) {
+#if SUPERVISOR_WATCHDOG
+  g_watchdogHook = hook;
+  // 初期化済み（Arduinoコア）なら時間とパニック有無の再設定になる
+  esp_task_wdt_init(WATCHDOG_TIMEOUT_S, true);
+  ESP_ERROR_CHECK(esp_task_wdt_add(nullptr));
+#else
+  (void)hook;
+#endif
+}
+
+void failsafeWatchdogFeed() {
+#if SUPERVISOR_WATCHDOG
+  esp_task_wdt_reset();
+#endif
+}
+
+void failsafeReport(Print& out) {
+  const uint8_t reason = g_failsafe.lastReason;
+  out.printf("failsafe count=%u last=%s", (unsigned)g_failsafe.count,
+             reason < sizeof(REASON_NAMES) / sizeof(REASON_NAMES[0]) ? REASON_NAMES[reason] : "?");
+  if (g_failsafe.lastChannel != FAILSAFE_NO_CHANNEL) out.printf(" ch=%u", (unsigned)g_failsafe.lastChannel);
+  out.printf(" rtc_us=%lld\n", (long long)g_failsafe.lastRtcUs);
+}
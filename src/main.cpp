@@ -1,182 +1,473 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <Arduino.h>
+#include <esp_timer.h>
+#include <soc/gpio_struct.h>
+#include <driver/gpio.h>
+#include <esp_sleep.h>
+#include "supervisor.h"
+#include "ulp_supervisor.h"
+#include "bench.h"
+#include "replay.h"
+#include "trace_log.h"
+#include "supervisor_stats.h"
+#include "boot_profile.h"
+#include "cpu_dfs.h"
+#include "tuning_store.h"
+#include "failsafe.h"
+#include "probe.h"
+#include "telemetry.h"
+#include "power_profile.h"
 
-//==================== ピン設定 ====================
-constexpr int PIN_RESET = 1;   // TPS3424EVM -> MCU (Active HIGH, push-pull)
-constexpr int PIN_INT   = 2;   // TPS3424EVM -> MCU (Active LOW, open-drain)
-constexpr int PIN_KILL  = 3;   // MCU -> TPS3424EVM (Active LOW)
+//==================== ビルド設定 ====================
+// KILL_ASSERT_IN_ISR / LOW_POWER_MODE / EDGE_CAPTURE_MCPWM は supervisor_config.h
+#if SUPERVISOR_BENCH && (LOW_POWER_MODE || SUPERVISOR_ULP_MODE)
+  #error "SUPERVISOR_BENCH measures the always-awake path; disable LOW_POWER_MODE / SUPERVISOR_ULP_MODE"
+#endif
+#if SUPERVISOR_REPLAY && (SUPERVISOR_BENCH || SUPERVISOR_ULP_MODE)
+  #error "SUPERVISOR_REPLAY drives the bench loopback pins from the main CPU; disable SUPERVISOR_BENCH / SUPERVISOR_ULP_MODE"
+#endif
+#if SUPERVISOR_TELEMETRY && (SUPERVISOR_REPLAY || SUPERVISOR_BENCH)
+  #error "SUPERVISOR_TELEMETRY shares the serial port with the console; SUPERVISOR_REPLAY / SUPERVISOR_BENCH own it"
+#endif
+
+//==================== タスク設定 ====================
+// 監視タスクはイベント待ちでブロックし、アプリは他方のコアを自由に使える
+// 無線（Wi-Fi/BLEのタスクと割り込み）は core 0 に置き、監視のISR・タスク・LEDは core 1 に固定する
+// （KILLの最低保持/タイムアウトの esp_timer タスクは core 0 なので、無線負荷で遅れ得る。
+//   遅れてもRESET立下りでの解放はISRで行い、タイムアウトの超過はフェイルセーフが解放する）
+constexpr BaseType_t  SUPERVISOR_CORE      = 1;
+constexpr UBaseType_t SUPERVISOR_TASK_PRIO = configMAX_PRIORITIES - 2; // esp_timerタスクより上
+constexpr uint32_t    SUPERVISOR_STACK     = 4096;
 
+//==================== チャネル設定 ====================
 // 内蔵LED（ボードによりHIGH/LOW極性が異なるので定数で吸収）
 #ifndef LED_BUILTIN
   #define LED_BUILTIN 21
 #endif
-constexpr bool LED_ACTIVE_HIGH = false; // 内蔵LEDがアクティブLOWなら false
 
-//==================== 時間パラメータ ====================
-// INT直後の「KILL無視窓」を超えるための最低保持
-constexpr uint32_t KILL_MIN_HOLD_MS  = 10;
-// 念のための上限（RESETがLOWにならなくても解放）
-constexpr uint32_t KILL_TIMEOUT_MS   = 1000;
-// INT入力のチャタリング抑制
-constexpr uint32_t INT_DEBOUNCE_MS   = 10;
-// 「RESETがHになってからこの時間以上継続している時だけKILLする」
-constexpr uint32_t RESET_HIGH_MIN_MS_BEFORE_INT = 10; // 環境で50〜150ms程度を調整
+// TPS3424EVM #0（時間パラメータは SupervisorDefaults のまま）
+struct Channel0 : SupervisorDefaults {
+  static constexpr uint8_t CHANNEL   = 0;
+  static constexpr int     PIN_RESET = 1;   // TPS3424EVM -> MCU (Active HIGH, push-pull)
+  static constexpr int     PIN_INT   = 2;   // TPS3424EVM -> MCU (Active LOW, open-drain)
+  static constexpr int     PIN_KILL  = 3;   // MCU -> TPS3424EVM (Active LOW)
+  static constexpr int     PIN_LED   = LED_BUILTIN;
+  static constexpr bool    LED_ACTIVE_HIGH = false; // 内蔵LEDがアクティブLOWなら false
+};
 
-//=== LEDパターン指定 ===
-constexpr uint8_t  STARTUP_BLINK_COUNT   = 3;
-constexpr uint32_t STARTUP_BLINK_ON_MS   = 120;  // 「100–150ms」の中庸
-constexpr uint32_t STARTUP_BLINK_OFF_MS  = 120;  // 同上
-constexpr uint32_t POWERDOWN_BLINK_ON_MS = 500;
+// 2台目以降は同様に定義し、CHANNEL の順に並べる（INT/RESET/KILL は GPIO0〜31、LEDは省略可）
+//   struct Channel1 : SupervisorDefaults {
+//     static constexpr uint8_t CHANNEL = 1;
+//     static constexpr int PIN_RESET = 4, PIN_INT = 5, PIN_KILL = 6;
+//   };
+//   using Supervisors = SupervisorSet<Supervisor<Channel0>, Supervisor<Channel1>>;
+using Supervisors = SupervisorSet<Supervisor<Channel0>>;
 
-//=== 起動時のKILL抑止 ===
-constexpr uint32_t STARTUP_INHIBIT_MAX_MS = 1000; // 念のための上限
+#if SUPERVISOR_BENCH || SUPERVISOR_REPLAY
+// 計測/リプレイ用ループバック（TPS3424EVMの代わりに配線する）
+constexpr int      BENCH_PIN_RESET_DRV = 4; // -> Channel0::PIN_RESET
+constexpr int      BENCH_PIN_INT_DRV   = 5; // -> Channel0::PIN_INT
+constexpr int      BENCH_PIN_SCRATCH   = 6; // 未接続（GPIO操作コストの比較用）
+constexpr uint32_t BENCH_CYCLES        = 2000;
+constexpr uint32_t REPLAY_KILL_WINDOW_US = 2000; // INT立下りからKILLを待つ上限
+#endif
+
+//=== 低消費電力モード ===
+constexpr uint32_t LIGHT_SLEEP_IDLE_MS = 20; // 最後のイベントからスリープ判定までの猶予
 
 //==================== 共有変数 ====================
-// ISR→main 連携用（必要最小限）
-volatile bool     g_intPending = false;
-volatile uint32_t g_resetHighSinceMs = 0;  // RESETがHになった瞬間の刻印（0なら直前までL）
-volatile bool     g_doKillFlag = false;    // ISRで判定済み「KILLすべきか」
-volatile bool     g_startupInhibit = false;
-
-// ループ側状態
-bool     g_lastReset = false;
-bool     g_killActive = false;
-uint32_t g_killAssertAt = 0;
-uint32_t g_startupInhibitAtMs  = 0;
-
-//==================== ユーティリティ ====================
-inline void setLed(bool on) {
-  digitalWrite(
-    LED_BUILTIN,
-    (LED_ACTIVE_HIGH ? (on ? HIGH : LOW) : (on ? LOW : HIGH))
-  );
-}
+TaskHandle_t g_supervisorTask = nullptr;
 
-// KILLアイドル: Hi-Z + 内部プルアップでH維持
-inline void killIdle() {
-  pinMode(PIN_KILL, INPUT_PULLUP);
-}
+//==================== ライトスリープ（LOW_POWER_MODE） ====================
+#if LOW_POWER_MODE
+// 起床統計（wake→KILL は esp_light_sleep_start() 復帰からアサート完了まで。
+// エッジ→復帰のハード起床遅延は含まないので、そちらはスコープで確認する）
+struct SleepStats {
+  uint32_t sleeps = 0;
+  uint32_t wakeKills = 0;          // 起床直後にKILLした回数
+  usec_t   lastWakeToKillUs = 0;
+  usec_t   maxWakeToKillUs  = 0;
+};
+SleepStats g_sleepStats;
 
-// KILLアサート: 強制L
-inline void killAssert() {
-  pinMode(PIN_KILL, OUTPUT);
-  digitalWrite(PIN_KILL, LOW);
-}
+// 全チャネルでKILL/抑止/LED/未処理イベントのいずれも無い時だけ眠る
+void lightSleepIfIdle() {
+  if (!Supervisors::idle()) return;
+  // INT=L 継続中はレベル起床が即成立するので眠らない
+  if (Supervisors::anyIntLow()) return;
+
+  Supervisors::sleepPrepare();
+  esp_sleep_enable_gpio_wakeup();
+
+  const usec_t sleepAt = nowUs();
+  esp_light_sleep_start();
+  // esp_timer は睡眠時間を補正して継続するので RESET=H の刻印はそのまま有効
+  usec_t wakeAt = nowUs();
+  profileNoteSleep(static_cast<uint32_t>(wakeAt - sleepAt));
+
+  Supervisors::sleepRestore();
+  ++g_sleepStats.sleeps;
 
-// LED点滅（ブロッキング、終了時は消灯）
-inline void blinkNTimes(uint8_t n, uint32_t onMs, uint32_t offMs) {
-  for (uint8_t i = 0; i < n; ++i) {
-    setLed(true);
-    delay(onMs);
-    setLed(false);
-    if (i + 1 < n) delay(offMs);
+  noInterrupts();
+  bool intFell = Supervisors::sleepSynthesize(wakeAt);
+  interrupts();
+  Supervisors::sleepResume();
+
+  Supervisors::handleEvents();
+  if (intFell) {
+    if (Supervisors::anyKillActive()) {
+      usec_t latency = nowUs() - wakeAt;
+      ++g_sleepStats.wakeKills;
+      g_sleepStats.lastWakeToKillUs = latency;
+      if (latency > g_sleepStats.maxWakeToKillUs) g_sleepStats.maxWakeToKillUs = latency;
+      log_i("wake->KILL %lld us (max %lld us)",
+            (long long)latency, (long long)g_sleepStats.maxWakeToKillUs);
+    }
   }
 }
+#endif
 
-// 起動シーケンス：短点灯×3回 & KILL抑止ON
-inline void startPowerOnSequence() {
-  g_startupInhibit = true;
-  g_startupInhibitAtMs = millis();
-  blinkNTimes(STARTUP_BLINK_COUNT, STARTUP_BLINK_ON_MS, STARTUP_BLINK_OFF_MS);
-  // 通常動作ではLED消灯を維持
-  setLed(false);
+// ISRからの通知でのみ起床（KILL保持＆解放はタイマとRESET ISRが担当）
+// SUPERVISOR_WATCHDOG ではタスクウォッチドッグへの給餌のため WATCHDOG_FEED_MS 毎にも起きる
+void supervisorTask(void*) {
+#if LOW_POWER_MODE
+  const TickType_t wait = pdMS_TO_TICKS(LIGHT_SLEEP_IDLE_MS);
+#elif SUPERVISOR_WATCHDOG
+  const TickType_t wait = pdMS_TO_TICKS(WATCHDOG_FEED_MS);
+#else
+  const TickType_t wait = portMAX_DELAY;
+#endif
+  failsafeWatchdogAdd(Supervisors::forceKillIdle);
+  for (;;) {
+    failsafeWatchdogFeed();
+    uint32_t bits = 0;
+    if (xTaskNotifyWait(0, UINT32_MAX, &bits, wait) != pdTRUE) {
+#if LOW_POWER_MODE
+      lightSleepIfIdle();
+#endif
+      continue;
+    }
+    bool held = dfsTakeEventHold();
+    if (bits & NOTIFY_EVENT) Supervisors::handleEvents();
+    if (held) dfsRelease(DfsHold::Event);
+  }
 }
 
-// 電源OFFシーケンス：やや長い点灯×1回
-inline void powerOffIndication() {
-  setLed(true);
-  delay(POWERDOWN_BLINK_ON_MS);
-  setLed(false);
-}
+//==================== ULP監視モード（SUPERVISOR_ULP_MODE） ====================
+#if SUPERVISOR_ULP_MODE
+// ULPが監視するのは Channel0 のみ
+using UlpChannel = Channel0;
+// ESP32-S3 では RTC IO 番号 = GPIO 番号（GPIO0〜21）
+static_assert(UlpChannel::PIN_RESET >= 0 && UlpChannel::PIN_RESET <= 21 &&
+              UlpChannel::PIN_INT   >= 0 && UlpChannel::PIN_INT   <= 21 &&
+              UlpChannel::PIN_KILL  >= 0 && UlpChannel::PIN_KILL  <= 21,
+              "SUPERVISOR_ULP_MODE requires RTC-capable pins (GPIO0-21) for RESET/INT/KILL");
 
-//==================== 割り込み（INT立下り） ====================
-// INT直前に RESET=H が十分続いていたかで KILL可否を即決
-void IRAM_ATTR onIntFalling() {
-  uint32_t now = millis();
-  static uint32_t last = 0;
-  if (now - last < INT_DEBOUNCE_MS) return; // デバウンス
-  last = now;
+// ULPの判定周期（時間パラメータはこの粒度に切り上げ）
+constexpr uint32_t ULP_TICK_US = 1000;
+// ULPの比較は16bit即値（RESET=H の最低継続は +1 して比較する）
+static_assert(TUNING_KILL_TIMEOUT_MAX_US / ULP_TICK_US < 0xFFFF &&
+              TUNING_RESET_HIGH_MAX_US / ULP_TICK_US < 0xFFFF &&
+              TUNING_STARTUP_INHIBIT_MAX_US / ULP_TICK_US < 0xFFFF &&
+              TUNING_DEBOUNCE_MAX_US / ULP_TICK_US < 0xFFFF,
+              "tuning limits must fit ULP 16-bit ticks");
 
-  uint32_t since = g_resetHighSinceMs; // 0なら直前までL
-  bool highLongEnough = (since != 0) && (now - since >= RESET_HIGH_MIN_MS_BEFORE_INT);
+inline uint16_t toUlpTicks(uint32_t us) {
+  return static_cast<uint16_t>((us + ULP_TICK_US - 1) / ULP_TICK_US);
+}
 
-  // 起動直後の点滅中はKILL抑止
-  bool killAllowed = !g_startupInhibit;
+// LEDの極性（実行時設定）はコールドブートで読み、ULP起床毎にはNVSを読まない
+RTC_DATA_ATTR bool g_ulpLedActiveHigh = UlpChannel::LED_ACTIVE_HIGH;
 
-  g_doKillFlag = highLongEnough && killAllowed;
-  g_intPending = true;
-}
+// 起床理由に応じてLED表示だけ行い、再びディープスリープへ（戻らない）。
+// 制御はULPが担うので、メインCPUはLEDパターンをその場で再生してよい。
+// 戻るのはコールドブートでULPを起動できなかった時だけ（以降は通常どおりメインCPUで監視する）
+void ulpModeMain() {
+  gpio_hold_dis((gpio_num_t)UlpChannel::PIN_LED);
+  const bool coldBoot = esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_ULP;
 
-//==================== セットアップ ====================
-void setup() {
-  pinMode(PIN_RESET, INPUT);          // TPS3424EVMのpush-pull出力を受ける
-  pinMode(PIN_INT,   INPUT_PULLUP);   // OD想定でプルアップ
-  pinMode(LED_BUILTIN, OUTPUT);
-  setLed(false);
-  killIdle();                         // 起動時は確実にKILL=H
-
-  g_lastReset = (digitalRead(PIN_RESET) == HIGH);
-  g_resetHighSinceMs = g_lastReset ? millis() : 0;
-
-  // 起動時にすでにRESET=Hなら、毎回起動点滅を実行（A案）
-  if (g_lastReset) {
-    startPowerOnSequence();
+  if (coldBoot) {
+    // 閾値とLED極性は通常の監視と同じ実行時設定（NVSの保存値、無ければ Config の既定値）。
+    // INT_FILTER_SAMPLED の安定幅は使わない。ULPの実行中は 'W' / 'D' を受けないので、
+    // 設定の変更は通常ビルドで保存し、次のコールドブートで反映される
+    SupervisorTuning t = SupervisorTuning::of<UlpChannel>();
+    SupervisorTuning saved;
+    if (tuningLoad(UlpChannel::CHANNEL, saved)) {
+      if (tuningValid<UlpChannel>(saved)) t = saved;
+      else log_w("tuning ch=%u in NVS is out of range, using defaults", (unsigned)UlpChannel::CHANNEL);
+    }
+    g_ulpLedActiveHigh = t.ledActiveHigh != 0;
+    Led<UlpChannel>::pinBegin();
+    Led<UlpChannel>::setActiveHigh(g_ulpLedActiveHigh);
+
+    // コールドブート: ULPを起動（RESET=Hなら毎回起動点滅、A案を踏襲）
+    const UlpConfig cfg = {
+      UlpChannel::PIN_RESET, UlpChannel::PIN_INT, UlpChannel::PIN_KILL, UlpChannel::KILL_ACTIVE_LOW,
+      ULP_TICK_US,
+      toUlpTicks(t.intDebounceUs),
+      toUlpTicks(t.resetHighMinUs),
+      toUlpTicks(t.startupInhibitMaxUs),
+      toUlpTicks(t.killMinHoldUs),
+      toUlpTicks(t.killTimeoutUs),
+    };
+    const esp_err_t err = ulpSupervisorInit(cfg);
+    if (err != ESP_OK) {
+      log_e("ULP supervisor failed to start (%s), supervising from the main CPU", esp_err_to_name(err));
+      return;
+    }
+    if (ulpSupervisorState().lastReset) Led<UlpChannel>::playBlocking(LED_PATTERN_POWER_ON);
+  } else {
+    Led<UlpChannel>::pinBegin();
+    Led<UlpChannel>::setActiveHigh(g_ulpLedActiveHigh);
+    uint32_t events = ulpSupervisorTakeEvents();
+    log_i("ULP events 0x%02x", (unsigned)events);
+    // 立上り/立下りが両方溜まっていたら現在のレベルを優先
+    bool resetHigh = ulpSupervisorState().lastReset != 0;
+    if (resetHigh && (events & ULP_EVT_RESET_RISE)) {
+      Led<UlpChannel>::playBlocking(LED_PATTERN_POWER_ON);
+    } else if (!resetHigh && (events & ULP_EVT_RESET_FALL)) {
+      Led<UlpChannel>::playBlocking(LED_PATTERN_POWER_OFF);
+    }
   }
 
-  attachInterrupt(digitalPinToInterrupt(PIN_INT), onIntFalling, FALLING);
+  // ディープスリープ中もLED消灯を保持
+  gpio_hold_en((gpio_num_t)UlpChannel::PIN_LED);
+  gpio_deep_sleep_hold_en();
+  ulpSupervisorSleep();
 }
+#endif
 
-//==================== ループ ====================
-void loop() {
-  // 1) RESET監視（立下り/立上りでのみLEDアクション）
-  bool nowReset = (digitalRead(PIN_RESET) == HIGH);
-  if (nowReset != g_lastReset) {
-    if (nowReset) {
-      // 立上り: 電源ONインジケータ（毎回実行）
-      g_resetHighSinceMs = millis();
-      startPowerOnSequence();
-    } else {
-      // 立下り: 電源OFFインジケータ
-      g_resetHighSinceMs = 0;
-      powerOffIndication();
-    }
-    g_lastReset = nowReset;
+//==================== 高速起動（SUPERVISOR_FAST_BOOT） ====================
+#if SUPERVISOR_FAST_BOOT && !SUPERVISOR_ULP_MODE
+// C++静的初期化の段階（app_main・Arduinoコア初期化より前）でKILLをアイドルに固定し、
+// INT立下りの計数（PCNT）を始める（Arduinoコア初期化・setup() の間の押下を arm() で判定する）。
+// ここで呼んでよいのはレジスタ直書き（killIdleEarly / intCountEarly）と、esp_timer の早期初期化後に読める
+// 時刻の記録（bootMark）だけ。ドライバ（GPIO）・NVS・ログの準備は setup() の begin() で行う
+__attribute__((constructor)) static void supervisorEarlyInit() {
+  Supervisors::killIdleEarly();
+  Supervisors::intCountEarly();
+  bootMark(BootStage::EarlyInit);
+}
+#endif
+
+//==================== 実行時設定（NVS） ====================
+// 保存値のあるチャネルだけ上書きする（範囲外の保存値は既定値のまま）
+void tuningLoadAll() {
+  for (uint8_t ch = 0; ch < Supervisors::COUNT; ++ch) {
+    SupervisorTuning t;
+    if (!tuningLoad(ch, t)) continue;
+    if (!Supervisors::setTuning(ch, t)) log_w("tuning ch=%u in NVS is out of range, using defaults", (unsigned)ch);
   }
+}
 
-  // 1.5) 起動シーケンスのKILL抑止解除条件
-  if (g_startupInhibit) {
-    uint32_t elapsed = millis() - g_startupInhibitAtMs;
-    // RESETが一度Lになったら解除、もしくは最大時間経過で解除
-    if (!nowReset || (elapsed >= STARTUP_INHIBIT_MAX_MS)) {
-      g_startupInhibit = false;
-    }
+// 反映できたら保存して新しい設定を表示
+void tuningApply(uint8_t ch, const SupervisorTuning& t) {
+  if (!Supervisors::setTuning(ch, t)) {
+    Serial.printf("tuning error ch=%u out of range\n", (unsigned)ch);
+    return;
   }
+  if (!tuningSave(ch, t)) Serial.printf("tuning error ch=%u not saved\n", (unsigned)ch);
+  tuningPrintLine(Serial, ch, t);
+}
 
-  // 2) INTイベント処理（ISR外で軽量に）
-  if (g_intPending) {
-    noInterrupts();
-    bool doKill = g_doKillFlag;
-    g_intPending = false;
-    interrupts();
-
-    if (doKill && !g_killActive) {
-      killAssert();
-      g_killActive   = true;
-      g_killAssertAt = millis();
-    }
+//==================== セットアップ ====================
+void setup() {
+  bootMark(BootStage::SetupEntry);
+#if SUPERVISOR_ULP_MODE
+  ulpModeMain(); // ULPを起動できた時は戻らない
+#endif
+  dfsBegin();                          // 以降のKILL/LED/イベント処理中だけ最大周波数
+  Supervisors::begin(SUPERVISOR_CORE); // ピン（起動時は確実にKILL非アクティブ）・タイマ・LEDタスク
+#if !SUPERVISOR_FAST_BOOT
+  Serial.begin(115200);
+#endif
+  traceBegin();                        // ISR登録より前に（前回までの記録は残す）
+
+  Supervisors::arm(SUPERVISOR_CORE);   // 共通GPIO割り込みの確保（監視コア）とピン割り込みの有効化
+  bootMark(BootStage::Armed);
+#if SUPERVISOR_FAST_BOOT
+  Serial.begin(115200);                // 監視開始を優先し、USB CDCの準備は後回し
+#endif
+
+  // 監視タスクは初期化完了後に生成し、それまでに溜まったイベントを処理させる
+  xTaskCreatePinnedToCore(supervisorTask, "supervisor", SUPERVISOR_STACK, nullptr,
+                          SUPERVISOR_TASK_PRIO, &g_supervisorTask, SUPERVISOR_CORE);
+  xTaskNotify(g_supervisorTask, NOTIFY_EVENT, eSetBits);
+  failsafeBackstopBegin(Supervisors::onBackstop); // 監視タスク・esp_timer が止まった時の強制解放/アサート
+
+  // 監視開始までは Config の既定値で動かし、フラッシュ読み出しはその後に回す
+  tuningLoadAll();
+  telemetryBegin();                    // 前回までの記録も含めて送出（SUPERVISOR_TELEMETRY）
+
+#if SUPERVISOR_BENCH
+  // 待ち時間は実際に動いている設定（NVS / 'W' で変更済みならその値）から決める
+  SupervisorTuning bt;
+  Supervisors::tuning(Channel0::CHANNEL, bt);
+  benchBegin(BenchConfig{
+    .pinKill       = Channel0::PIN_KILL,
+    .drvReset      = BENCH_PIN_RESET_DRV,
+    .drvInt        = BENCH_PIN_INT_DRV,
+    .pinScratch    = BENCH_PIN_SCRATCH,
+    .cycles        = BENCH_CYCLES,
+    .resetSettleUs = bt.startupInhibitMaxUs + bt.resetHighMinUs + 5000,
+    .killHoldUs    = bt.killMinHoldUs + 5000,
+    .cycleGapUs    = bt.intDebounceUs + 5000,
+    .timeoutUs     = bt.killTimeoutUs,
+  });
+#endif
+#if SUPERVISOR_REPLAY
+  replayBegin(ReplayConfig{
+    .pinKill       = Channel0::PIN_KILL,
+    .killActiveLow = Channel0::KILL_ACTIVE_LOW,
+    .drvReset      = BENCH_PIN_RESET_DRV,
+    .drvInt        = BENCH_PIN_INT_DRV,
+    .killWindowUs  = REPLAY_KILL_WINDOW_US,
+  });
+#endif
+}
+
+//==================== シリアルコマンド ====================
+// 1バイトコマンド（改行などその他のバイトは無視）
+//   'T': 永続トレースをバイナリ出力、'X': 永続トレースを消去
+//   'S': 稼働統計をバイナリ出力、's': 稼働統計をチャネル毎に1行テキストで出力
+//   'C': 稼働統計・電源OFFプロファイル・最大周波数の滞在を消去
+//   'Q': 最大周波数の滞在（SUPERVISOR_DFS、理由毎の回数と時間）を1行テキストで出力
+//   'H': 電源OFFプロファイル（直近 PROFILE_HISTORY 回の区間毎の分布）をテキストで出力、'L': 同じ窓の記録を1回1行で出力
+//   'B': リセットから監視開始までの時刻と、フェイルセーフの記録（前回の起動分を含む）を1行ずつテキストで出力
+//   'R': 計測プローブ（SUPERVISOR_PROBES）の集計をプローブ毎に1行テキストで出力、'Z': 集計を消去
+//   'P': 実行時設定をチャネル毎に1行テキストで出力
+//   'W': 実行時設定の1項目を変更してNVSへ保存。"W0 hold_us 20000\n"（チャネル 名前 値、名前は 'P' の出力と同じ）
+//   'D': 実行時設定を既定値に戻し、NVSの保存値を消去
+//   'F': INT_FILTER_SAMPLED の安定幅。"F2000\n" で全チャネルを 2000µs に（保存する）、"F\n" は表示のみ、数字以外は拒否
+// SUPERVISOR_TELEMETRY では応答の間だけテレメトリの送出を止め、フレームと混ざらないようにする
+constexpr uint32_t CONSOLE_POLL_MS = 20;
+
+// 電源OFFプロファイルをチャネル毎に出力（each: 記録を1回1行で、false なら分布）
+void profilePrintAll(bool each) {
+  static PowerCycleProfile records[PROFILE_HISTORY]; // loopタスク専用の作業領域
+  for (uint8_t ch = 0; ch < Supervisors::COUNT; ++ch) {
+    uint32_t count = 0, total = 0;
+    if (!Supervisors::profile(ch, records, count, total)) continue;
+    if (each) profilePrintRecords(Serial, ch, records, count, total);
+    else      profileReport(Serial, ch, records, count, total);
   }
+}
 
-  // 3) KILL保持＆解放ロジック
-  if (g_killActive) {
-    uint32_t elapsed   = millis() - g_killAssertAt;
-    bool     resetLow  = (digitalRead(PIN_RESET) == LOW);
-    bool     minHoldOk = (elapsed >= KILL_MIN_HOLD_MS);
+// 10進の非負整数を1つ読み、p を続きの位置へ進める（数字なし・負の数・桁あふれは拒否）
+bool consoleParseCount(const char*& p, uint32_t& out) {
+  char* end = nullptr;
+  errno = 0;
+  const long v = strtol(p, &end, 10);
+  if (end == p || errno == ERANGE || v < 0) return false;
+  out = static_cast<uint32_t>(v);
+  p = end;
+  return true;
+}
 
-    if ((resetLow && minHoldOk) || (elapsed >= KILL_TIMEOUT_MS)) {
-      killIdle();
-      g_killActive = false;
+void handleConsole() {
+  SupervisorStats stats[Supervisors::COUNT];
+  while (Serial.available() > 0) {
+    TelemetrySerialGuard guard;
+    switch (Serial.read()) {
+      case 'T': traceDump(Serial); break;
+      case 'X': traceClear();      break;
+      case 'S':
+        Supervisors::stats(stats);
+        statsDumpBinary(Serial, stats, Supervisors::COUNT);
+        break;
+      case 's':
+        Supervisors::stats(stats);
+        for (uint8_t ch = 0; ch < Supervisors::COUNT; ++ch) statsPrintLine(Serial, ch, stats[ch]);
+        break;
+      case 'C':
+        Supervisors::clearStats();
+        dfsClear();
+        break;
+      case 'Q': dfsReport(Serial); break;
+      case 'H': profilePrintAll(false); break;
+      case 'L': profilePrintAll(true);  break;
+      case 'R': probeReport(Serial); break;
+      case 'Z': probeClear();        break;
+      case 'B':
+        bootReport(Serial);
+        failsafeReport(Serial);
+        break;
+      case 'P':
+        for (uint8_t ch = 0; ch < Supervisors::COUNT; ++ch) {
+          SupervisorTuning t;
+          if (Supervisors::tuning(ch, t)) tuningPrintLine(Serial, ch, t);
+        }
+        break;
+      case 'W': {
+        String line = Serial.readStringUntil('\n');
+        line.trim();
+        // "チャネル 名前 値"。負の数・余分な文字は拒否し、チャネルは8bitへ丸める前に範囲を確かめる
+        // （"W256 ..." が ch=0、"W0 hold_us -1" が 0xFFFFFFFF にならないように）
+        const char* p = line.c_str();
+        uint32_t ch = 0, value = 0;
+        char name[16] = {};
+        int used = 0;
+        bool ok = consoleParseCount(p, ch) && *p == ' ' && sscanf(p, " %15s%n", name, &used) == 1;
+        if (ok) {
+          p += used;
+          ok = consoleParseCount(p, value) && *p == '\0';
+        }
+        SupervisorTuning t;
+        if (!ok || ch >= Supervisors::COUNT ||
+            !Supervisors::tuning(static_cast<uint8_t>(ch), t) || !tuningSetField(t, name, value)) {
+          Serial.printf("tuning error bad command \"W%s\"\n", line.c_str());
+          break;
+        }
+        tuningApply(static_cast<uint8_t>(ch), t);
+        break;
+      }
+      case 'D':
+        for (uint8_t ch = 0; ch < Supervisors::COUNT; ++ch) tuningErase(ch);
+        Supervisors::resetTuning();
+        break;
+#if INT_FILTER_SAMPLED
+      case 'F': {
+        String line = Serial.readStringUntil('\n');
+        line.trim();
+        // 空行は表示のみ。数字以外・余分な文字・0以下は拒否（範囲は setTuning() が判定）
+        long us = 0;
+        if (line.length() > 0) {
+          char* end = nullptr;
+          us = strtol(line.c_str(), &end, 10);
+          if (end == line.c_str() || *end != '\0' || us <= 0) {
+            Serial.printf("tuning error bad command \"F%s\"\n", line.c_str());
+            break;
+          }
+        }
+        for (uint8_t ch = 0; ch < Supervisors::COUNT; ++ch) {
+          SupervisorTuning t;
+          if (!Supervisors::tuning(ch, t)) continue;
+          if (us > 0) {
+            t.intFilterUs = static_cast<uint32_t>(us);
+            tuningApply(ch, t);
+          } else {
+            tuningPrintLine(Serial, ch, t);
+          }
+        }
+        break;
+      }
+#endif
+      default: break;
     }
   }
+}
 
-  // 4) 最小ディレイ（WDTケア＆CPU占有防止）
-  delay(1);
+//==================== ループ ====================
+// 監視は専用タスクで行うため、Arduinoのloopタスクはシリアルコマンドのみ担当
+// （SUPERVISOR_REPLAY ではシリアル入力をリプレイタスクが専有）
+void loop() {
+  {
+    PROBE_SCOPE(Loop); // 待ち（delay）は含めない
+#if !SUPERVISOR_REPLAY
+    handleConsole();
+#endif
+  }
+  delay(CONSOLE_POLL_MS);
 }
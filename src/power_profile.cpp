@@ -0,0 +1,90 @@
+#include "power_profile.h"
+#include "supervisor_event.h"
+
+volatile uint32_t g_profileSleepUs = 0;
+
+namespace {
+
+struct ProfileMetric {
+  const char* name;
+  uint32_t PowerCycleProfile::*field;
+};
+
+const ProfileMetric PROFILE_METRICS[] = {
+  {"on_us",            &PowerCycleProfile::onUs},
+  {"int_to_kill_us",   &PowerCycleProfile::intToKillUs},
+  {"kill_to_reset_us", &PowerCycleProfile::killToResetUs},
+  {"held_us",          &PowerCycleProfile::killHeldUs},
+  {"led_us",           &PowerCycleProfile::ledUs},
+  {"sleep_us",         &PowerCycleProfile::sleepUs},
+};
+
+uint8_t histBucket(uint32_t us) {
+  uint8_t log2 = us == 0 ? 0 : static_cast<uint8_t>(31 - __builtin_clz(us));
+  if (log2 < PROFILE_HIST_LOG2_MIN) return 0;
+  log2 -= PROFILE_HIST_LOG2_MIN;
+  return log2 < PROFILE_HIST_BUCKETS ? log2 : PROFILE_HIST_BUCKETS - 1;
+}
+
+// 昇順に並べる（高々 PROFILE_HISTORY 件なので挿入ソート）
+void sortValues(uint32_t* v, uint32_t n) {
+  for (uint32_t i = 1; i < n; ++i) {
+    uint32_t x = v[i];
+    uint32_t j = i;
+    for (; j > 0 && v[j - 1] > x; --j) v[j] = v[j - 1];
+    v[j] = x;
+  }
+}
+
+void printValue(Print& out, const char* key, uint32_t v) {
+  if (v == PROFILE_NONE) out.printf(" %s=none", key);
+  else                   out.printf(" %s=%u", key, (unsigned)v);
+}
+
+} // namespace
+
+void profileReport(Print& out, uint8_t channel, const PowerCycleProfile* records, uint32_t count, uint32_t total) {
+  uint32_t rel[5] = {};
+  for (uint32_t i = 0; i < count; ++i) {
+    if (records[i].release < 5) ++rel[records[i].release];
+  }
+  out.printf("profile ch=%u cycles=%u window=%u rel_reset=%u rel_hold=%u rel_timeout=%u rel_backstop=%u\n",
+             (unsigned)channel, (unsigned)total, (unsigned)count,
+             (unsigned)rel[static_cast<uint8_t>(TraceRelease::ResetFall)],
+             (unsigned)rel[static_cast<uint8_t>(TraceRelease::HoldElapsed)],
+             (unsigned)rel[static_cast<uint8_t>(TraceRelease::Timeout)],
+             (unsigned)rel[static_cast<uint8_t>(TraceRelease::Backstop)]);
+
+  uint32_t values[PROFILE_HISTORY];
+  for (const ProfileMetric& m : PROFILE_METRICS) {
+    uint32_t n = 0;
+    uint16_t hist[PROFILE_HIST_BUCKETS] = {};
+    for (uint32_t i = 0; i < count && n < PROFILE_HISTORY; ++i) {
+      const uint32_t v = records[i].*m.field;
+      if (v == PROFILE_NONE) continue;
+      values[n++] = v;
+      ++hist[histBucket(v)];
+    }
+    out.printf("profile ch=%u m=%s n=%u", (unsigned)channel, m.name, (unsigned)n);
+    if (n > 0) {
+      sortValues(values, n);
+      out.printf(" min=%u p50=%u p90=%u max=%u", (unsigned)values[0], (unsigned)values[n / 2],
+                 (unsigned)values[(n * 9) / 10], (unsigned)values[n - 1]);
+    }
+    out.print(" hist=");
+    for (uint8_t b = 0; b < PROFILE_HIST_BUCKETS; ++b) {
+      out.printf(b == 0 ? "%u" : ",%u", (unsigned)hist[b]);
+    }
+    out.print("\n");
+  }
+}
+
+void profilePrintRecords(Print& out, uint8_t channel, const PowerCycleProfile* records, uint32_t count,
+                         uint32_t total) {
+  for (uint32_t i = 0; i < count; ++i) {
+    const PowerCycleProfile& p = records[i];
+    out.printf("cycle ch=%u index=%u", (unsigned)channel, (unsigned)(total - count + i));
+    for (const ProfileMetric& m : PROFILE_METRICS) printValue(out, m.name, p.*m.field);
+    out.printf(" release=%u\n", (unsigned)p.release);
+  }
+}
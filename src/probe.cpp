@@ -0,0 +1,46 @@
+#include "probe.h"
+#include <string.h>
+
+ProbeBucket g_probes[PROBE_CORES][static_cast<size_t>(ProbeId::Count)] = {};
+
+namespace {
+
+const char* const PROBE_NAMES[] = {
+  "gpio_isr", "int_falling", "reset_edge", "kill_release", "handle_events", "led_tick", "backstop", "loop",
+};
+static_assert(sizeof(PROBE_NAMES) / sizeof(PROBE_NAMES[0]) == static_cast<size_t>(ProbeId::Count),
+              "PROBE_NAMES must match ProbeId");
+
+} // namespace
+
+void probeReport(Print& out) {
+  if (!SUPERVISOR_PROBES) {
+    out.print("probe disabled\n");
+    return;
+  }
+  for (size_t i = 0; i < static_cast<size_t>(ProbeId::Count); ++i) {
+    // コア毎のバケツを写してから合算（別コアで記録中の1件とはずれ得るが、診断用なので許容）
+    ProbeBucket sum = {};
+    for (uint8_t core = 0; core < PROBE_CORES; ++core) {
+      const uint32_t irq = portSET_INTERRUPT_MASK_FROM_ISR();
+      const ProbeBucket b = g_probes[core][i];
+      portCLEAR_INTERRUPT_MASK_FROM_ISR(irq);
+      if (b.count == 0) continue;
+      if (sum.count == 0 || b.minCycles < sum.minCycles) sum.minCycles = b.minCycles;
+      if (b.maxCycles > sum.maxCycles) sum.maxCycles = b.maxCycles;
+      sum.sumCycles += b.sumCycles;
+      sum.count += b.count;
+    }
+    if (sum.count == 0) continue;
+    out.printf("probe %s n=%u min=%u avg=%u max=%u cyc\n", PROBE_NAMES[i], (unsigned)sum.count,
+               (unsigned)sum.minCycles, (unsigned)(sum.sumCycles / sum.count), (unsigned)sum.maxCycles);
+  }
+}
+
+void probeClear() {
+  for (uint8_t core = 0; core < PROBE_CORES; ++core) {
+    const uint32_t irq = portSET_INTERRUPT_MASK_FROM_ISR();
+    memset(g_probes[core], 0, sizeof(g_probes[core]));
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(irq);
+  }
+}
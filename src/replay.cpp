@@ -0,0 +1,182 @@
+#include "replay.h"
+
+#if SUPERVISOR_REPLAY
+
+#include <Arduino.h>
+#include <soc/gpio_struct.h>
+#include "supervisor_config.h"
+#include "replay_format.h"
+
+namespace {
+
+constexpr BaseType_t  REPLAY_CORE  = 0;    // 監視タスク（SUPERVISOR_CORE=1）と別コア
+constexpr UBaseType_t REPLAY_PRIO  = 1;
+constexpr uint32_t    REPLAY_STACK = 4096;
+
+// クレジット: 送信側は付与された分だけ送る（HWCDCの受信バッファ256Bに収める）
+constexpr uint32_t REPLAY_WINDOW      = 240; // 開始時に付与
+constexpr uint32_t REPLAY_CREDIT_STEP = 120; // 消費するたびに追加付与
+// この時間より先のエッジはタスク遅延で待ち、残りは空回しで合わせる
+constexpr usec_t   REPLAY_SPIN_US     = 2000;
+// これより遅れて駆動したエッジを数える
+constexpr usec_t   REPLAY_LATE_US     = 50;
+// 入力が途切れてからこの時間で1本のリプレイを終える
+constexpr usec_t   REPLAY_IDLE_END_US = 2000000;
+// 受信が始まるまで ready を繰り返す間隔（送信側の接続が後でもよいように）
+constexpr usec_t   REPLAY_READY_EVERY_US = 1000000;
+
+ReplayConfig g_cfg;
+
+inline void drive(int pin, bool high) {
+  if (high) GPIO.out_w1ts = 1u << pin;
+  else      GPIO.out_w1tc = 1u << pin;
+}
+
+inline bool killAsserted() {
+  bool padHigh = ((GPIO.in >> g_cfg.pinKill) & 1u) != 0;
+  return padHigh != g_cfg.killActiveLow;
+}
+
+struct Totals {
+  uint32_t edges;
+  uint32_t intFalls;
+  uint32_t kills;
+  uint32_t late;
+  usec_t   maxLateUs;
+};
+
+class Replayer {
+ public:
+  void reset() {
+    decoder_ = ReplayDecoder();
+    totals_ = {};
+    haveEdge_ = false;
+    started_ = false;
+    anyInput_ = false;
+    consumed_ = 0;
+    drive(g_cfg.drvReset, false);
+    drive(g_cfg.drvInt, true);
+    announce();
+  }
+
+  // 1回分の処理（次のエッジを取り出し、時刻まで待って駆動）
+  void step() {
+    if (!haveEdge_ && !fetch()) {
+      if (started_ && nowUs() - lastInputUs_ > REPLAY_IDLE_END_US) finish();
+      else if (!anyInput_ && nowUs() - readyAtUs_ > REPLAY_READY_EVERY_US) announce();
+      else vTaskDelay(1);
+      return;
+    }
+    usec_t target = targetUs_ + edge_.deltaUs;
+    if (target - nowUs() > REPLAY_SPIN_US) {
+      vTaskDelay(1); // 受信も進める
+      return;
+    }
+    while (nowUs() < target) {}
+    targetUs_ = target;
+    haveEdge_ = false;
+    if (edge_.signal == ReplaySignal::Gap) return;
+
+    const bool killBefore = killAsserted();
+    drive(edge_.signal == ReplaySignal::Reset ? g_cfg.drvReset : g_cfg.drvInt, edge_.high);
+    const usec_t at = nowUs();
+    ++totals_.edges;
+    usec_t late = at - target;
+    if (late > REPLAY_LATE_US) ++totals_.late;
+    if (late > totals_.maxLateUs) totals_.maxLateUs = late;
+    if (edge_.signal == ReplaySignal::Int && !edge_.high) reportIntFall(at, killBefore);
+  }
+
+ private:
+  // 開始時の付与（送信側は受信前なら値で置き換える）
+  void announce() {
+    readyAtUs_ = nowUs();
+    Serial.printf("replay ready credit=%u\n", (unsigned)REPLAY_WINDOW);
+  }
+
+  // 受信済みバイトから記録を1つ取り出す
+  bool fetch() {
+    while (Serial.available() > 0) {
+      int b = Serial.read();
+      if (b < 0) break;
+      lastInputUs_ = nowUs();
+      anyInput_ = true;
+      if (++consumed_ >= REPLAY_CREDIT_STEP) {
+        consumed_ = 0;
+        Serial.printf("replay credit=%u\n", (unsigned)REPLAY_CREDIT_STEP);
+      }
+      if (decoder_.error()) continue; // 不正な入力は途切れるまで読み捨て
+      if (decoder_.push(static_cast<uint8_t>(b), edge_)) {
+        if (!started_) {
+          started_ = true;
+          startUs_ = targetUs_ = nowUs() + REPLAY_SPIN_US; // 最初の待ちを空回しに収める
+        }
+        haveEdge_ = true;
+        return true;
+      }
+      if (decoder_.error()) Serial.println("replay error bad header or record");
+    }
+    return false;
+  }
+
+  // 駆動側のコアで空回ししてKILLを待つ（次のエッジの時刻か上限まで）
+  void reportIntFall(usec_t at, bool killBefore) {
+    ++totals_.intFalls;
+    const usec_t atReplay = at - startUs_;
+    if (killBefore) {
+      Serial.printf("replay at_us=%lld int kill_active\n", (long long)atReplay);
+      return;
+    }
+    usec_t limit = at + g_cfg.killWindowUs;
+    if (haveEdge_ || fetch()) {
+      usec_t next = targetUs_ + edge_.deltaUs;
+      if (next < limit) limit = next;
+    }
+    while (nowUs() < limit) {
+      if (killAsserted()) {
+        ++totals_.kills;
+        Serial.printf("replay at_us=%lld int kill lat_us=%lld\n", (long long)atReplay, (long long)(nowUs() - at));
+        return;
+      }
+    }
+    Serial.printf("replay at_us=%lld int no_kill\n", (long long)atReplay);
+  }
+
+  void finish() {
+    Serial.printf("replay done edges=%u int=%u kills=%u late=%u max_late_us=%lld\n",
+                  (unsigned)totals_.edges, (unsigned)totals_.intFalls, (unsigned)totals_.kills,
+                  (unsigned)totals_.late, (long long)totals_.maxLateUs);
+    reset();
+  }
+
+  ReplayDecoder decoder_;
+  ReplayEdge    edge_ = {};
+  Totals        totals_ = {};
+  bool          haveEdge_ = false;
+  bool          started_ = false;
+  bool          anyInput_ = false;
+  usec_t        readyAtUs_ = 0;
+  usec_t        startUs_ = 0;
+  usec_t        targetUs_ = 0;   // 直前に駆動した記録の予定時刻
+  usec_t        lastInputUs_ = 0;
+  uint32_t      consumed_ = 0;
+};
+
+Replayer g_replayer;
+
+void replayTask(void*) {
+  g_replayer.reset();
+  for (;;) g_replayer.step();
+}
+
+} // namespace
+
+void replayBegin(const ReplayConfig& cfg) {
+  g_cfg = cfg;
+  pinMode(cfg.drvReset, OUTPUT);
+  pinMode(cfg.drvInt,   OUTPUT);
+  xTaskCreatePinnedToCore(replayTask, "replay", REPLAY_STACK, nullptr,
+                          REPLAY_PRIO, nullptr, REPLAY_CORE);
+}
+
+#endif // SUPERVISOR_REPLAY
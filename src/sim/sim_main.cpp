@@ -0,0 +1,225 @@
+// ホスト実行のシミュレーション（env:native）
+// 疑似乱数で電源ボタン操作の波形（チャタリング・短押し・RESETの瞬断）を生成し、
+// 疑似ボード上の実機と同じ監視（HostSupervisor、supervisor_host.h）へ流して判定結果と規則違反の有無を集計する。
+//   使い方: program [cycles] [seed] [-v]   （-v: 判定を1件ずつ出力）
+//           program --replay <file|->      （replay_format.h のエッジ列を流し、判定を1件ずつ出力）
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "supervisor_host.h"
+#include "replay_format.h"
+
+namespace {
+
+// 実機の Channel0 と同じ時間パラメータ（ピンは疑似ボード上の番号）
+struct SimChannel : SupervisorDefaults {
+  static constexpr uint8_t CHANNEL   = 0;
+  static constexpr int     PIN_RESET = 1;
+  static constexpr int     PIN_INT   = 2;
+  static constexpr int     PIN_KILL  = 3;
+};
+using Rig = HostRig<SimChannel>;
+using Sv  = Rig::Sv;
+
+// xorshift64（再現性のためシードを固定できるもの）
+class Rng {
+ public:
+  explicit Rng(uint64_t seed) : s_(seed != 0 ? seed : 1) {}
+  uint64_t next() {
+    s_ ^= s_ << 13;
+    s_ ^= s_ >> 7;
+    s_ ^= s_ << 17;
+    return s_;
+  }
+  // [lo, hi] の一様乱数
+  usec_t range(usec_t lo, usec_t hi) {
+    return lo + static_cast<usec_t>(next() % static_cast<uint64_t>(hi - lo + 1));
+  }
+  bool chance(uint32_t percent) { return next() % 100 < percent; }
+
+ private:
+  uint64_t s_;
+};
+
+const char* outcomeName(IntOutcome o) {
+  switch (o) {
+    case IntOutcome::Kill:           return "kill";
+    case IntOutcome::Debounced:      return "debounced";
+    case IntOutcome::ResetTooShort:  return "reset_short";
+    case IntOutcome::StartupInhibit: return "inhibit";
+    default:                         return "none";
+  }
+}
+
+// KILLの保持時間が規則どおりかを監視（判定の出力は -v のときだけ）
+// （判定とKILL解放は永続トレースの記録、アサートはKILLピンの出力有効化で受け取る）
+class Checker : public HostObserver {
+ public:
+  explicit Checker(bool verbose) : verbose_(verbose) {}
+
+  void onTrace(usec_t at, TraceKind kind, uint8_t code) override {
+    if (kind == TraceKind::IntFall) {
+      const IntOutcome outcome = static_cast<IntOutcome>(code & 0x0F);
+      if (verbose_) printf("%lld int %s\n", (long long)at, outcomeName(outcome));
+    } else if (kind == TraceKind::KillRelease) {
+      usec_t held = at - assertAt_;
+      if (held < SimChannel::KILL_MIN_HOLD_US || held > SimChannel::KILL_TIMEOUT_US) ++violations;
+      if (verbose_) printf("%lld release %u held_us=%lld\n", (long long)at, (unsigned)(code & 0x0F), (long long)held);
+    }
+  }
+  void onKill(usec_t at, int pin, bool driven) override {
+    if (pin != SimChannel::PIN_KILL || !driven) return;
+    assertAt_ = at;
+    if (verbose_) printf("%lld kill\n", (long long)at);
+  }
+
+  uint64_t violations = 0;
+
+ private:
+  bool   verbose_;
+  usec_t assertAt_ = 0;
+};
+
+// INTを押す（チャタリングつき）。押下中にKILLされたらTPS3424側がRESETを落とす
+usec_t press(Rng& rng, usec_t t, uint64_t& edges) {
+  uint32_t bounces = static_cast<uint32_t>(rng.range(0, 6));
+  for (uint32_t i = 0; i < bounces; ++i) {
+    Rig::intLevel(t, false);
+    t += rng.range(20, 3000);
+    Rig::intLevel(t, true);
+    t += rng.range(20, 3000);
+    edges += 2;
+  }
+  Rig::intLevel(t, false);
+  ++edges;
+  usec_t releaseAt = t + rng.range(30000, 400000); // 押下時間
+  // KILLへの応答: 最低保持より前/後、まれに応答なし（タイムアウト）
+  usec_t resetFallAt = -1;
+  if (rng.chance(95)) resetFallAt = t + rng.range(1000, 3 * SimChannel::KILL_MIN_HOLD_US);
+  Rig::advanceTo(t + 1);
+  if (Sv::killActive() && resetFallAt >= 0) {
+    Rig::reset(resetFallAt, false);
+    ++edges;
+  }
+  if (releaseAt < Rig::board().now()) releaseAt = Rig::board().now() + 1;
+  Rig::intLevel(releaseAt, true);
+  ++edges;
+  return releaseAt;
+}
+
+void printCounters(const SupervisorStats& n, uint64_t violations) {
+  printf("ch=0 int=%llu debounced=%llu inhibit=%llu reset_short=%llu kills=%llu "
+         "rel_reset=%llu rel_timeout=%llu violations=%llu\n",
+         (unsigned long long)n.intEdges, (unsigned long long)n.intDebounced,
+         (unsigned long long)n.suppressedInhibit, (unsigned long long)n.suppressedResetShort,
+         (unsigned long long)n.kills, (unsigned long long)n.releaseResetLow,
+         (unsigned long long)n.releaseTimeout, (unsigned long long)violations);
+}
+
+// 疑似ボードを初期化し、RESET=L / INT=H で立ち上げる
+void startRig(Checker& checker) {
+  Rig::board().reset();
+  Rig::board().observe(&checker);
+  Rig::start(0, false, true);
+}
+
+// 記録を読みながら流す（ファイル全体は読み込まない）。開始時は RESET=L / INT=H
+int replay(FILE* in) {
+  Checker checker(true);
+  startRig(checker);
+
+  ReplayDecoder decoder;
+  ReplayEdge edge;
+  uint64_t edges = 0;
+  usec_t   t = 0;
+  uint8_t  chunk[4096];
+  size_t   n;
+  while ((n = fread(chunk, 1, sizeof(chunk), in)) > 0) {
+    for (size_t i = 0; i < n; ++i) {
+      if (!decoder.push(chunk[i], edge)) continue;
+      t += edge.deltaUs;
+      switch (edge.signal) {
+        case ReplaySignal::Reset: Rig::reset(t, edge.high);    ++edges; break;
+        case ReplaySignal::Int:   Rig::intLevel(t, edge.high); ++edges; break;
+        case ReplaySignal::Gap:   Rig::advanceTo(t);                    break;
+      }
+    }
+    if (decoder.error()) break;
+  }
+  if (decoder.error()) {
+    fprintf(stderr, "replay: bad header or record after %llu edges\n", (unsigned long long)edges);
+    return 2;
+  }
+  Rig::advanceTo(t + SimChannel::KILL_TIMEOUT_US); // 末尾のKILLを収束させる
+  printf("replay edges=%llu virtual_s=%.6f\n", (unsigned long long)edges, t / 1e6);
+  printCounters(Sv::stats(), checker.violations);
+  return checker.violations == 0 ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  uint64_t cycles = 100000;
+  uint64_t seed   = 1;
+  bool     verbose = false;
+  int      pos = 0;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+      const char* path = argv[++i];
+      FILE* in = strcmp(path, "-") == 0 ? stdin : fopen(path, "rb");
+      if (in == nullptr) {
+        fprintf(stderr, "replay: cannot open %s\n", path);
+        return 2;
+      }
+      int rc = replay(in);
+      if (in != stdin) fclose(in);
+      return rc;
+    }
+    if (strcmp(argv[i], "-v") == 0) verbose = true;
+    else if (pos++ == 0) cycles = strtoull(argv[i], nullptr, 0);
+    else seed = strtoull(argv[i], nullptr, 0);
+  }
+
+  Rng rng(seed);
+  Checker checker(verbose);
+  startRig(checker);
+
+  const clock_t start = clock();
+  uint64_t edges = 0;
+  usec_t   t = 1000;
+  for (uint64_t c = 0; c < cycles; ++c) {
+    // 電源ON（まれに RESET_HIGH_MIN 未満の瞬断つき）
+    Rig::reset(t, true);
+    ++edges;
+    if (rng.chance(10)) {
+      t += rng.range(100, SimChannel::RESET_HIGH_MIN_US_BEFORE_INT - 1);
+      Rig::reset(t, false);
+      t += rng.range(100, 5000);
+      Rig::reset(t, true);
+      edges += 2;
+    }
+    // 1回目の操作は起動抑止・RESET継続不足に掛かることもある
+    t += rng.range(0, 2 * SimChannel::STARTUP_INHIBIT_MAX_US);
+    t = press(rng, t, edges);
+    if (Rig::board().now() > t) t = Rig::board().now();
+    // KILLされなかった（RESET=H のまま）なら押し直す
+    t += SimChannel::INT_DEBOUNCE_US + rng.range(1000, 50000);
+    if (!Sv::killActive()) {
+      t = press(rng, t, edges);
+    }
+    // タイムアウト分も含めて収束させ、電源OFFで区切る
+    t += SimChannel::KILL_TIMEOUT_US + 1;
+    Rig::reset(t, false);
+    ++edges;
+    t += rng.range(1000, 100000);
+  }
+  Rig::advanceTo(t);
+  const double sec = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+
+  printf("sim cycles=%llu edges=%llu virtual_s=%.1f host_s=%.3f edges_per_s=%.0f\n",
+         (unsigned long long)cycles, (unsigned long long)edges, t / 1e6, sec,
+         sec > 0 ? edges / sec : 0.0);
+  printCounters(Sv::stats(), checker.violations);
+  return checker.violations == 0 ? 0 : 1;
+}
@@ -0,0 +1,23 @@
+#include "supervisor_stats.h"
+#include "binary_frame.h"
+
+constexpr uint32_t STATS_MAGIC = 0x31415453; // 送出順に "STA1"
+constexpr uint16_t STATS_FIELDS = sizeof(SupervisorStats) / sizeof(uint32_t);
+void statsDumpBinary(Print& out, const SupervisorStats* channels, uint16_t count) {
+  FrameWriter frame(out, STATS_MAGIC);
+  frame.put(&STATS_FIELDS, sizeof(STATS_FIELDS));
+  frame.put(&count, sizeof(count));
+  frame.put(channels, count * sizeof(SupervisorStats));
+  frame.finish();
+}
+
+void statsPrintLine(Print& out, uint8_t channel, const SupervisorStats& s) {
+  out.printf("ch=%u int=%u debounced=%u inhibit=%u reset_short=%u kill=%u "
+             "rel_reset=%u rel_timeout=%u dropped=%u max_lat_us=%u glitches=%u "
+             "bs_release=%u bs_assert=%u\n",
+             (unsigned)channel, (unsigned)s.intEdges, (unsigned)s.intDebounced,
+             (unsigned)s.suppressedInhibit, (unsigned)s.suppressedResetShort,
+             (unsigned)s.kills, (unsigned)s.releaseResetLow, (unsigned)s.releaseTimeout,
+             (unsigned)s.eventsDropped, (unsigned)s.maxKillLatencyUs, (unsigned)s.intGlitches,
+             (unsigned)s.backstopReleases, (unsigned)s.backstopAsserts);
+}
@@ -0,0 +1,146 @@
+#include "telemetry.h"
+
+#if SUPERVISOR_TELEMETRY
+
+#include <Arduino.h>
+#include <string.h>
+#include <freertos/semphr.h>
+#include "trace_log.h"
+
+namespace {
+
+constexpr uint32_t    TELEMETRY_MAGIC = 0x314D4C54; // 送出順に "TLM1"
+constexpr BaseType_t  TELEMETRY_CORE  = 0;          // 監視タスク（core 1）と別コア
+constexpr UBaseType_t TELEMETRY_PRIO  = 1;
+constexpr uint32_t    TELEMETRY_STACK = 3072;
+
+constexpr size_t HEADER_SIZE  = 4 + 2 + 2 + 4 + 4;
+constexpr size_t FRAME_MAX    = HEADER_SIZE + TELEMETRY_RECORDS_PER_FRAME * sizeof(TraceRecord) + 4;
+constexpr size_t ENCODED_MAX  = 1 + FRAME_MAX + FRAME_MAX / 254 + 1 + 1; // 区切り + COBS + 区切り
+
+uint8_t           g_frame[FRAME_MAX];
+uint8_t           g_encoded[ENCODED_MAX];
+uint32_t          g_nextIndex = 0; // 次に送る記録の書き込み通番
+uint16_t          g_frameSeq  = 0;
+SemaphoreHandle_t g_serialLock = nullptr;
+
+// CRC-32（反転多項式 0xEDB88320、初期値/最終XOR 0xFFFFFFFF。zlib.crc32 と一致）
+uint32_t crc32(const uint8_t* p, size_t len) {
+  uint32_t crc = 0xFFFFFFFFu;
+  for (size_t i = 0; i < len; ++i) {
+    crc ^= p[i];
+    for (int b = 0; b < 8; ++b) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+  }
+  return ~crc;
+}
+
+// COBS符号化（出力に 0x00 を含まない）。書き込んだバイト数を返す
+size_t cobsEncode(const uint8_t* in, size_t len, uint8_t* out) {
+  size_t  codeAt = 0;
+  size_t  o = 1;
+  uint8_t code = 1;
+  for (size_t i = 0; i < len; ++i) {
+    if (in[i] != 0) {
+      out[o++] = in[i];
+      ++code;
+    }
+    if (in[i] == 0 || code == 0xFF) {
+      out[codeAt] = code;
+      codeAt = o++;
+      code = 1;
+    }
+  }
+  out[codeAt] = code;
+  return o;
+}
+
+inline void putLe(uint8_t*& p, const void* v, size_t n) {
+  memcpy(p, v, n);
+  p += n;
+}
+
+// 記録を最大 TELEMETRY_RECORDS_PER_FRAME 件取り出してフレームにし、送る（送った記録数を返す）
+uint16_t sendFrame() {
+  uint8_t* p = g_frame + HEADER_SIZE;
+  uint32_t written, boots;
+  uint16_t count = 0;
+  portENTER_CRITICAL(&g_traceMux);
+  written = g_trace.written;
+  boots   = g_trace.boots;
+  if (written < g_nextIndex) g_nextIndex = 0;                                  // traceClear() 後
+  if (written - g_nextIndex > TRACE_LOG_LEN) g_nextIndex = written - TRACE_LOG_LEN; // 上書き済みは飛ばす
+  const uint32_t first = g_nextIndex;
+  while (g_nextIndex != written && count < TELEMETRY_RECORDS_PER_FRAME) {
+    putLe(p, &g_trace.records[g_nextIndex & (TRACE_LOG_LEN - 1)], sizeof(TraceRecord));
+    ++g_nextIndex;
+    ++count;
+  }
+  portEXIT_CRITICAL(&g_traceMux);
+
+  uint8_t* h = g_frame;
+  const uint16_t seq = g_frameSeq++;
+  putLe(h, &TELEMETRY_MAGIC, 4);
+  putLe(h, &seq, 2);
+  putLe(h, &count, 2);
+  putLe(h, &first, 4);
+  putLe(h, &boots, 4);
+  const uint32_t crc = crc32(g_frame, p - g_frame);
+  putLe(p, &crc, 4);
+
+  g_encoded[0] = 0;
+  size_t n = 1 + cobsEncode(g_frame, p - g_frame, g_encoded + 1);
+  g_encoded[n++] = 0;
+  xSemaphoreTake(g_serialLock, portMAX_DELAY);
+  Serial.write(g_encoded, n);
+  xSemaphoreGive(g_serialLock);
+  return count;
+}
+
+bool pending() {
+  portENTER_CRITICAL(&g_traceMux);
+  bool any = g_trace.written != g_nextIndex;
+  portEXIT_CRITICAL(&g_traceMux);
+  return any;
+}
+
+void telemetryTask(void*) {
+  TickType_t lastSent = xTaskGetTickCount();
+  for (;;) {
+    vTaskDelay(pdMS_TO_TICKS(TELEMETRY_PERIOD_MS));
+    // ホスト未接続なら送らない（記録はトレースに残り、溢れた分は firstIndex の飛びで分かる）
+    if (!Serial) continue;
+    const bool heartbeat = xTaskGetTickCount() - lastSent >= pdMS_TO_TICKS(TELEMETRY_HEARTBEAT_MS);
+    if (!pending() && !heartbeat) continue;
+    while (sendFrame() == TELEMETRY_RECORDS_PER_FRAME) {}
+    lastSent = xTaskGetTickCount();
+  }
+}
+
+} // namespace
+
+void telemetryBegin() {
+  g_serialLock = xSemaphoreCreateMutex();
+  // 前回の起動までの記録（リングに残っている分）から送る
+  portENTER_CRITICAL(&g_traceMux);
+  const uint32_t written = g_trace.written;
+  g_nextIndex = written > TRACE_LOG_LEN ? written - TRACE_LOG_LEN : 0;
+  portEXIT_CRITICAL(&g_traceMux);
+  xTaskCreatePinnedToCore(telemetryTask, "telemetry", TELEMETRY_STACK, nullptr,
+                          TELEMETRY_PRIO, nullptr, TELEMETRY_CORE);
+}
+
+void telemetrySerialLock() {
+  if (g_serialLock != nullptr) xSemaphoreTake(g_serialLock, portMAX_DELAY);
+}
+
+void telemetrySerialUnlock() {
+  if (g_serialLock != nullptr) xSemaphoreGive(g_serialLock);
+}
+
+#else
+
+void telemetryBegin() {}
+void telemetrySerialLock() {}
+void telemetrySerialUnlock() {}
+
+#endif // SUPERVISOR_TELEMETRY
@@ -0,0 +1,48 @@
+#include "trace_log.h"
+#include "binary_frame.h"
+#include <esp_system.h>
+#include <esp_timer.h>
+
+constexpr uint32_t TRACE_MAGIC = 0x31435254; // 送出順に "TRC1"
+
+RTC_NOINIT_ATTR TraceLog g_trace;
+portMUX_TYPE g_traceMux = portMUX_INITIALIZER_UNLOCKED;
+
+void traceClear() {
+  portENTER_CRITICAL(&g_traceMux);
+  memset(&g_trace, 0, sizeof(g_trace));
+  g_trace.magic = TRACE_MAGIC;
+  portEXIT_CRITICAL(&g_traceMux);
+}
+
+void traceBegin() {
+  if (g_trace.magic != TRACE_MAGIC) traceClear(); // 電源投入（またはレイアウト変更）
+  ++g_trace.boots;
+  traceWrite(esp_timer_get_time(), TraceKind::Boot, static_cast<uint8_t>(esp_reset_reason()));
+}
+
+//==================== バイナリ出力 ====================
+// FrameWriter形式、ペイロード:
+//   u16 recordSize | u16 count | u32 written | u32 boots | TraceRecord × count（古い順）
+// 出力中も書き込みは続くので、記録はスナップショットを取ってから送る
+static TraceRecord g_snapshot[TRACE_LOG_LEN];
+
+void traceDump(Print& out) {
+  portENTER_CRITICAL(&g_traceMux);
+  const uint32_t written = g_trace.written;
+  const uint32_t boots   = g_trace.boots;
+  memcpy(g_snapshot, g_trace.records, sizeof(g_snapshot));
+  portEXIT_CRITICAL(&g_traceMux);
+
+  const uint16_t count = static_cast<uint16_t>(written < TRACE_LOG_LEN ? written : TRACE_LOG_LEN);
+  const uint16_t size  = sizeof(TraceRecord);
+  FrameWriter frame(out, TRACE_MAGIC);
+  frame.put(&size,    sizeof(size));
+  frame.put(&count,   sizeof(count));
+  frame.put(&written, sizeof(written));
+  frame.put(&boots,   sizeof(boots));
+  for (uint32_t i = written - count; i != written; ++i) {
+    frame.put(&g_snapshot[i & (TRACE_LOG_LEN - 1)], sizeof(TraceRecord));
+  }
+  frame.finish();
+}
@@ -0,0 +1,93 @@
+#include "tuning_store.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <Preferences.h>
+
+namespace {
+
+constexpr const char* TUNING_NAMESPACE = "supervisor";
+constexpr uint32_t    TUNING_VERSION   = 1; // フィールドを変えたら上げる
+
+struct TuningBlob {
+  uint32_t         version;
+  SupervisorTuning tuning;
+};
+
+void keyFor(uint8_t channel, char (&key)[5]) {
+  snprintf(key, sizeof(key), "t%u", (unsigned)channel);
+}
+
+struct Field {
+  const char* name;
+  size_t      offset;
+};
+
+// シリアルでの名前（出力順）
+const Field FIELDS[] = {
+  {"hold_us",      offsetof(SupervisorTuning, killMinHoldUs)},
+  {"timeout_us",   offsetof(SupervisorTuning, killTimeoutUs)},
+  {"debounce_us",  offsetof(SupervisorTuning, intDebounceUs)},
+  {"reset_min_us", offsetof(SupervisorTuning, resetHighMinUs)},
+  {"inhibit_us",   offsetof(SupervisorTuning, startupInhibitMaxUs)},
+  {"filter_us",    offsetof(SupervisorTuning, intFilterUs)},
+  {"led_high",     offsetof(SupervisorTuning, ledActiveHigh)},
+};
+static_assert(sizeof(FIELDS) / sizeof(FIELDS[0]) == sizeof(SupervisorTuning) / sizeof(uint32_t),
+              "FIELDS must cover SupervisorTuning");
+
+inline uint32_t& fieldRef(SupervisorTuning& t, const Field& f) {
+  return *reinterpret_cast<uint32_t*>(reinterpret_cast<uint8_t*>(&t) + f.offset);
+}
+
+} // namespace
+
+bool tuningLoad(uint8_t channel, SupervisorTuning& out) {
+  char key[5];
+  keyFor(channel, key);
+  Preferences prefs;
+  if (!prefs.begin(TUNING_NAMESPACE, true)) return false; // 名前空間が未作成
+  TuningBlob blob;
+  size_t len = prefs.getBytes(key, &blob, sizeof(blob));
+  prefs.end();
+  if (len != sizeof(blob) || blob.version != TUNING_VERSION) return false;
+  out = blob.tuning;
+  return true;
+}
+
+bool tuningSave(uint8_t channel, const SupervisorTuning& t) {
+  char key[5];
+  keyFor(channel, key);
+  Preferences prefs;
+  if (!prefs.begin(TUNING_NAMESPACE, false)) return false;
+  const TuningBlob blob = {TUNING_VERSION, t};
+  bool ok = prefs.putBytes(key, &blob, sizeof(blob)) == sizeof(blob);
+  prefs.end();
+  return ok;
+}
+
+void tuningErase(uint8_t channel) {
+  char key[5];
+  keyFor(channel, key);
+  Preferences prefs;
+  if (!prefs.begin(TUNING_NAMESPACE, false)) return;
+  prefs.remove(key);
+  prefs.end();
+}
+
+void tuningPrintLine(Print& out, uint8_t channel, const SupervisorTuning& t) {
+  out.printf("ch=%u", (unsigned)channel);
+  SupervisorTuning copy = t;
+  for (const Field& f : FIELDS) out.printf(" %s=%u", f.name, (unsigned)fieldRef(copy, f));
+  out.print("\n");
+}
+
+bool tuningSetField(SupervisorTuning& t, const char* name, uint32_t value) {
+  for (const Field& f : FIELDS) {
+    if (strcmp(f.name, name) == 0) {
+      fieldRef(t, f) = value;
+      return true;
+    }
+  }
+  return false;
+}
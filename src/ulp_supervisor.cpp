@@ -0,0 +1,240 @@
+#include "ulp_supervisor.h"
+
+#if SUPERVISOR_ULP_MODE
+
+#include <stddef.h>
+#include <Arduino.h>
+#include <esp_sleep.h>
+#include <driver/rtc_io.h>
+#include <soc/soc.h>
+#include <soc/rtc_io_reg.h>
+#include <soc/rtc_cntl_reg.h>
+#include <esp32s3/ulp.h>
+
+//==================== 共有状態の配置 ====================
+// RTC_SLOW_MEM 先頭に UlpSharedState、その直後にULPプログラムを置く
+#define ULP_VAR(field) static_cast<uint16_t>(offsetof(UlpSharedState, field) / sizeof(uint32_t))
+constexpr uint32_t ULP_PROG_START = sizeof(UlpSharedState) / sizeof(uint32_t);
+
+static_assert(sizeof(UlpSharedState) % sizeof(uint32_t) == 0, "UlpSharedState must be word-aligned");
+
+namespace {
+
+inline volatile UlpSharedState& state() {
+  return *reinterpret_cast<volatile UlpSharedState*>(RTC_SLOW_MEM);
+}
+
+// ESP32-S3 では RTC IO 番号 = GPIO 番号（GPIO0〜21）
+inline bool rtcCapable(int pin) {
+  return pin >= 0 && pin <= 21;
+}
+
+// プログラム内ラベル
+enum : uint32_t {
+  L_RESET_LOW,
+  L_RESET_LOW_CONT,
+  L_RESET_HIGH_CONT,
+  L_RESET_DONE,
+  L_INHIBIT_DONE,
+  L_DEBOUNCE_DONE,
+  L_INT_DONE,
+  L_KILL_RELEASE,
+  L_KILL_DONE,
+  L_DONE,
+};
+
+} // namespace
+
+//==================== ULPプログラム ====================
+// ティック毎（ULPタイマ起床）に1回走る。R3=共有状態の先頭、R0=比較用、R1/R2=前回/今回レベル
+//   1) RESET: 立上り/立下りを通知、H継続ティックを数える（onResetChange相当）
+//   2) 起動抑止の残りティックを減算
+//   3) INT立下り: デバウンス後、RESET=H継続・抑止・KILL中を見てアサート（onIntFalling相当）
+//   4) KILL: 最低保持後のRESET=L、またはタイムアウトで解放（onKillHoldElapsed/onKillTimeout相当）
+//   5) LED表示が必要な通知があればメインCPUを起こす
+static esp_err_t loadProgram(const UlpConfig& cfg) {
+  const uint32_t resetBit = RTC_GPIO_IN_NEXT_S + cfg.pinReset;
+  const uint32_t intBit   = RTC_GPIO_IN_NEXT_S + cfg.pinInt;
+  const uint32_t killEnS  = RTC_GPIO_ENABLE_W1TS_S + cfg.pinKill;
+  const uint32_t killEnC  = RTC_GPIO_ENABLE_W1TC_S + cfg.pinKill;
+
+  const ulp_insn_t program[] = {
+    I_MOVI(R3, 0),
+
+    // 1) RESET
+    I_RD_REG(RTC_GPIO_IN_REG, resetBit, resetBit),
+    I_MOVR(R2, R0),
+    I_LD(R1, R3, ULP_VAR(lastReset)),
+    I_ST(R2, R3, ULP_VAR(lastReset)),
+    M_BL(L_RESET_LOW, 1),
+    //   RESET=H: 立上りなら通知・抑止開始・継続ティックを数え直す
+    I_MOVR(R0, R1),
+    M_BGE(L_RESET_HIGH_CONT, 1),
+    I_LD(R0, R3, ULP_VAR(events)),
+    I_ORI(R0, R0, ULP_EVT_RESET_RISE),
+    I_ST(R0, R3, ULP_VAR(events)),
+    I_MOVI(R0, cfg.startupInhibitTicks),
+    I_ST(R0, R3, ULP_VAR(startupInhibit)),
+    I_MOVI(R0, 0),
+    I_ST(R0, R3, ULP_VAR(resetHighTicks)),
+    M_LABEL(L_RESET_HIGH_CONT),
+    I_LD(R0, R3, ULP_VAR(resetHighTicks)),
+    M_BGE(L_RESET_DONE, 0xFFFF),            // 飽和
+    I_ADDI(R0, R0, 1),
+    I_ST(R0, R3, ULP_VAR(resetHighTicks)),
+    M_BX(L_RESET_DONE),
+    //   RESET=L: 立下りなら通知・抑止解除
+    M_LABEL(L_RESET_LOW),
+    I_MOVR(R0, R1),
+    M_BL(L_RESET_LOW_CONT, 1),
+    I_LD(R0, R3, ULP_VAR(events)),
+    I_ORI(R0, R0, ULP_EVT_RESET_FALL),
+    I_ST(R0, R3, ULP_VAR(events)),
+    I_MOVI(R0, 0),
+    I_ST(R0, R3, ULP_VAR(startupInhibit)),
+    M_LABEL(L_RESET_LOW_CONT),
+    I_MOVI(R0, 0),
+    I_ST(R0, R3, ULP_VAR(resetHighTicks)),
+    M_LABEL(L_RESET_DONE),
+
+    // 2) 起動抑止
+    I_LD(R0, R3, ULP_VAR(startupInhibit)),
+    M_BL(L_INHIBIT_DONE, 1),
+    I_SUBI(R0, R0, 1),
+    I_ST(R0, R3, ULP_VAR(startupInhibit)),
+    M_LABEL(L_INHIBIT_DONE),
+
+    // 3) INT立下り
+    I_RD_REG(RTC_GPIO_IN_REG, intBit, intBit),
+    I_MOVR(R2, R0),
+    I_LD(R1, R3, ULP_VAR(lastInt)),
+    I_ST(R2, R3, ULP_VAR(lastInt)),
+    I_LD(R0, R3, ULP_VAR(intDebounce)),
+    M_BL(L_DEBOUNCE_DONE, 1),
+    I_SUBI(R0, R0, 1),                      // デバウンス中の立下りは捨てる
+    I_ST(R0, R3, ULP_VAR(intDebounce)),
+    M_BX(L_INT_DONE),
+    M_LABEL(L_DEBOUNCE_DONE),
+    I_MOVR(R0, R1),
+    M_BL(L_INT_DONE, 1),                    // 前回L
+    I_MOVR(R0, R2),
+    M_BGE(L_INT_DONE, 1),                   // 今回H
+    I_MOVI(R0, cfg.intDebounceTicks),
+    I_ST(R0, R3, ULP_VAR(intDebounce)),
+    I_LD(R0, R3, ULP_VAR(resetHighTicks)),
+    M_BL(L_INT_DONE, cfg.resetHighMinTicks + 1), // H継続不足（0=L を含む）
+    I_LD(R0, R3, ULP_VAR(startupInhibit)),
+    M_BGE(L_INT_DONE, 1),                   // 起動抑止中
+    I_LD(R0, R3, ULP_VAR(killActive)),
+    M_BGE(L_INT_DONE, 1),                   // アサート中
+    I_WR_REG(RTC_GPIO_ENABLE_W1TS_REG, killEnS, killEnS, 1), // 出力ラッチはアクティブ側に固定済み
+    I_MOVI(R0, 1),
+    I_ST(R0, R3, ULP_VAR(killActive)),
+    I_MOVI(R0, 0),
+    I_ST(R0, R3, ULP_VAR(killTicks)),
+    I_LD(R0, R3, ULP_VAR(events)),
+    I_ORI(R0, R0, ULP_EVT_KILL),
+    I_ST(R0, R3, ULP_VAR(events)),
+    M_LABEL(L_INT_DONE),
+
+    // 4) KILL保持＆解放
+    I_LD(R0, R3, ULP_VAR(killActive)),
+    M_BL(L_KILL_DONE, 1),
+    I_LD(R0, R3, ULP_VAR(killTicks)),
+    I_ADDI(R0, R0, 1),
+    I_ST(R0, R3, ULP_VAR(killTicks)),
+    M_BGE(L_KILL_RELEASE, cfg.killTimeoutTicks),
+    M_BL(L_KILL_DONE, cfg.killMinHoldTicks),
+    I_LD(R0, R3, ULP_VAR(lastReset)),
+    M_BGE(L_KILL_DONE, 1),                  // RESET=H の間は保持
+    M_LABEL(L_KILL_RELEASE),
+    I_WR_REG(RTC_GPIO_ENABLE_W1TC_REG, killEnC, killEnC, 1), // Hi-Z（非アクティブ側へプル）
+    I_MOVI(R0, 0),
+    I_ST(R0, R3, ULP_VAR(killActive)),
+    I_LD(R0, R3, ULP_VAR(events)),
+    I_ORI(R0, R0, ULP_EVT_KILL_RELEASE),
+    I_ST(R0, R3, ULP_VAR(events)),
+    M_LABEL(L_KILL_DONE),
+
+    // 5) メインCPU起床（スリープ中でなければ次ティックで再試行）
+    I_LD(R0, R3, ULP_VAR(events)),
+    I_ANDI(R0, R0, ULP_EVT_WAKE_MASK),
+    M_BL(L_DONE, 1),
+    I_RD_REG(RTC_CNTL_LOW_POWER_ST_REG, RTC_CNTL_RDY_FOR_WAKEUP_S, RTC_CNTL_RDY_FOR_WAKEUP_S),
+    M_BL(L_DONE, 1),
+    I_WAKE(),
+    M_LABEL(L_DONE),
+    I_HALT(),
+  };
+
+  size_t size = sizeof(program) / sizeof(ulp_insn_t);
+  return ulp_process_macros_and_load(ULP_PROG_START, program, &size);
+}
+
+//==================== 公開API ====================
+esp_err_t ulpSupervisorInit(const UlpConfig& cfg) {
+  // ピンは main.cpp の static_assert でも確かめている（ここは UlpConfig を直接組んだ場合の保険）
+  if (!rtcCapable(cfg.pinReset) || !rtcCapable(cfg.pinInt) || !rtcCapable(cfg.pinKill)) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  const gpio_num_t reset = static_cast<gpio_num_t>(cfg.pinReset);
+  const gpio_num_t intr  = static_cast<gpio_num_t>(cfg.pinInt);
+  const gpio_num_t kill  = static_cast<gpio_num_t>(cfg.pinKill);
+
+  // RESET: push-pull入力、INT: OD想定でプルアップ
+  rtc_gpio_init(reset);
+  rtc_gpio_set_direction(reset, RTC_GPIO_MODE_INPUT_ONLY);
+  rtc_gpio_init(intr);
+  rtc_gpio_set_direction(intr, RTC_GPIO_MODE_INPUT_ONLY);
+  rtc_gpio_pullup_en(intr);
+  // KILL: 出力ラッチをアクティブ側に固定し、出力有効/無効だけをULPが切り替える
+  // （アイドルはHi-Z＋非アクティブ側へのプル）
+  rtc_gpio_init(kill);
+  rtc_gpio_set_level(kill, cfg.killActiveLow ? 0 : 1);
+  rtc_gpio_set_direction(kill, RTC_GPIO_MODE_INPUT_ONLY);
+  if (cfg.killActiveLow) { rtc_gpio_pulldown_dis(kill); rtc_gpio_pullup_en(kill); }
+  else                   { rtc_gpio_pullup_dis(kill);   rtc_gpio_pulldown_en(kill); }
+
+  // 初期状態はメイン側 setup() と同じ扱い（RESET=Hなら今から継続・抑止開始）
+  const bool resetHigh = rtc_gpio_get_level(reset) != 0;
+  volatile UlpSharedState& s = state();
+  s.resetHighTicks = resetHigh ? 1 : 0;
+  s.lastReset      = resetHigh ? 1 : 0;
+  s.lastInt        = rtc_gpio_get_level(intr) != 0 ? 1 : 0;
+  s.intDebounce    = 0;
+  s.startupInhibit = resetHigh ? cfg.startupInhibitTicks : 0;
+  s.killActive     = 0;
+  s.killTicks      = 0;
+  s.events         = 0;
+
+  esp_err_t err = loadProgram(cfg);
+  if (err == ESP_OK) err = ulp_set_wakeup_period(0, cfg.tickUs);
+  if (err == ESP_OK) err = ulp_run(ULP_PROG_START);
+  if (err != ESP_OK) {
+    rtc_gpio_deinit(reset);
+    rtc_gpio_deinit(intr);
+    rtc_gpio_deinit(kill);
+  }
+  return err;
+}
+
+uint32_t ulpSupervisorTakeEvents() {
+  // ULPの読み書きと競合し得るが、取りこぼしても次回のRESETエッジで再通知される
+  volatile UlpSharedState& s = state();
+  uint32_t events = s.events & 0xFFFF;
+  s.events = 0;
+  return events;
+}
+
+const volatile UlpSharedState& ulpSupervisorState() {
+  return state();
+}
+
+void ulpSupervisorSleep() {
+  // RTC IOの入力とプルアップをディープスリープ中も維持
+  esp_sleep_pd_config(ESP_PD_DOMAIN_RTC_PERIPH, ESP_PD_OPTION_ON);
+  esp_sleep_enable_ulp_wakeup();
+  esp_deep_sleep_start();
+}
+
+#endif // SUPERVISOR_ULP_MODE
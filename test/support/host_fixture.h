@@ -0,0 +1,31 @@
+#pragma once
+// ホストテスト共通の治具（test_native / test_int_filter）
+//   env:native の build_flags に -Itest/support。監視の設定（INT_FILTER_SAMPLED 等）は
+//   このヘッダより前に #define する。
+// 各テストは別の TestChannel<ID> を使い、静的メンバ（チャネルの状態）を他のテストと共有しない。
+#include <unity.h>
+#include "supervisor_host.h"
+
+template <int ID>
+struct TestChannel : SupervisorDefaults {
+  static constexpr uint8_t CHANNEL   = 0;
+  static constexpr int     PIN_RESET = 4;
+  static constexpr int     PIN_INT   = 5;
+  static constexpr int     PIN_KILL  = 6;
+};
+using Defaults = SupervisorDefaults;
+
+constexpr usec_t RESET_MIN = Defaults::RESET_HIGH_MIN_US_BEFORE_INT;
+constexpr usec_t RISE_AT   = 100000; // RESET立上り（起動は時刻0、RESET=L）
+
+inline HostBoard& board() { return HostBoard::get(); }
+
+// 起動して RISE_AT で RESET を上げる（inhibit: 起動抑止の上限、0なら抑止なし）
+template <typename R>
+void powerOn(uint32_t inhibitUs) {
+  R::start(0, false);
+  SupervisorTuning t = R::Sv::tuning();
+  t.startupInhibitMaxUs = inhibitUs;
+  TEST_ASSERT_TRUE(R::Sv::setTuning(t));
+  R::reset(RISE_AT, true);
+}
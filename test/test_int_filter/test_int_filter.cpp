@@ -0,0 +1,109 @@
+// INTの安定判定（INT_FILTER_SAMPLED）を疑似ボード（supervisor_host.h）で動かすテスト
+//   pio test -e native
+// サンプラは最初の立下りから INT_FILTER_SAMPLE_US 周期。判定の時刻は最初の立下り。
+#define INT_FILTER_SAMPLED 1
+#include "host_fixture.h"
+
+namespace {
+
+constexpr usec_t SAMPLE_US = Defaults::INT_FILTER_SAMPLE_US;
+constexpr usec_t FILTER_US = Defaults::INT_FILTER_US;
+constexpr usec_t PRESS_AT  = RISE_AT + RESET_MIN; // RESET=H の最低継続を満たす最初の時刻
+
+} // namespace
+
+void setUp() { board().reset(); }
+
+void tearDown() {}
+
+// 安定幅より短いLはグリッチとして捨て、判定もエッジ数の計上もしない
+void test_short_low_is_glitch() {
+  using R = HostRig<TestChannel<1>>;
+  powerOn<R>(0); // 起動抑止なし
+  R::intLevel(PRESS_AT, false);
+  R::intLevel(PRESS_AT + FILTER_US / 2, true);
+  R::advanceTo(PRESS_AT + 4 * FILTER_US);
+  TEST_ASSERT_FALSE(R::kill());
+  const SupervisorStats s = R::Sv::stats();
+  TEST_ASSERT_EQUAL_UINT32(1, s.intGlitches);
+  TEST_ASSERT_EQUAL_UINT32(0, s.intEdges);
+
+  // エッジ割り込みへ戻っていて、次の押下は判定される
+  const usec_t again = PRESS_AT + 10 * FILTER_US;
+  R::intLevel(again, false);
+  R::advanceTo(again + FILTER_US);
+  TEST_ASSERT_TRUE(R::kill());
+}
+
+// 安定幅続いたLでKILL（サンプル数が安定幅に届いた周期で）
+void test_stable_low_kills_after_filter() {
+  using R = HostRig<TestChannel<2>>;
+  powerOn<R>(0); // 起動抑止なし
+  R::intLevel(PRESS_AT, false);
+  R::advanceTo(PRESS_AT + FILTER_US - 1);
+  TEST_ASSERT_FALSE(R::kill());
+  R::advanceTo(PRESS_AT + FILTER_US);
+  TEST_ASSERT_TRUE(R::kill());
+  const SupervisorStats s = R::Sv::stats();
+  TEST_ASSERT_EQUAL_UINT32(1, s.intEdges);
+  TEST_ASSERT_EQUAL_UINT32(0, s.intGlitches);
+}
+
+// サンプルに掛かったチャタリングは数え直すが、判定は最初の立下り1回だけ
+void test_chatter_restarts_count_and_keeps_first_fall() {
+  using R = HostRig<TestChannel<3>>;
+  powerOn<R>(0); // 起動抑止なし
+  R::intLevel(PRESS_AT, false);
+  R::intLevel(PRESS_AT + SAMPLE_US + SAMPLE_US / 2, true);     // 2回目のサンプルでH
+  R::intLevel(PRESS_AT + 2 * SAMPLE_US + SAMPLE_US / 2, false); // 3回目でLへ戻る
+  const usec_t confirmAt = PRESS_AT + 3 * SAMPLE_US + FILTER_US; // 3回目から数え直し
+  R::advanceTo(confirmAt - 1);
+  TEST_ASSERT_FALSE(R::kill());
+  R::advanceTo(confirmAt);
+  TEST_ASSERT_TRUE(R::kill());
+  TEST_ASSERT_EQUAL_UINT32(1, R::Sv::stats().intEdges);
+
+  // 通電時間は最初の立下りまで
+  R::reset(confirmAt + Defaults::KILL_MIN_HOLD_US, false);
+  PowerCycleProfile p[PROFILE_HISTORY];
+  uint32_t total = 0;
+  TEST_ASSERT_EQUAL_UINT32(1, R::Sv::profile(p, total));
+  TEST_ASSERT_EQUAL_UINT32(static_cast<uint32_t>(RESET_MIN), p[0].onUs);
+}
+
+// RESET=H の最低継続は確定時刻ではなく最初の立下りの時刻で判定する
+void test_reset_minimum_judged_at_first_fall() {
+  using R = HostRig<TestChannel<4>>;
+  powerOn<R>(0); // 起動抑止なし
+  R::intLevel(PRESS_AT - 1, false); // 確定時には RESET=H が足りているが、立下りの時刻では1µs足りない
+  R::advanceTo(PRESS_AT + 2 * FILTER_US);
+  TEST_ASSERT_FALSE(R::kill());
+  TEST_ASSERT_EQUAL_UINT32(1, R::Sv::stats().suppressedResetShort);
+}
+
+// 実行時設定の安定幅（'F' / 'W'）で確定が変わる
+void test_tuned_filter_width() {
+  using R = HostRig<TestChannel<5>>;
+  powerOn<R>(0); // 起動抑止なし
+  SupervisorTuning t = R::Sv::tuning();
+  t.intFilterUs = 4 * FILTER_US;
+  TEST_ASSERT_TRUE(R::Sv::setTuning(t));
+  R::intLevel(PRESS_AT, false);
+  R::advanceTo(PRESS_AT + 4 * FILTER_US - 1);
+  TEST_ASSERT_FALSE(R::kill());
+  R::advanceTo(PRESS_AT + 4 * FILTER_US);
+  TEST_ASSERT_TRUE(R::kill());
+
+  t.intFilterUs = SAMPLE_US - 1; // サンプル周期未満は受け付けない
+  TEST_ASSERT_FALSE(R::Sv::setTuning(t));
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_short_low_is_glitch);
+  RUN_TEST(test_stable_low_kills_after_filter);
+  RUN_TEST(test_chatter_restarts_count_and_keeps_first_fall);
+  RUN_TEST(test_reset_minimum_judged_at_first_fall);
+  RUN_TEST(test_tuned_filter_width);
+  return UNITY_END();
+}
@@ -0,0 +1,344 @@
+// 監視の状態機械（SupervisorCore）を疑似ボード（supervisor_host.h）で動かす境界条件のテスト
+//   pio test -e native
+// 同じ時刻のタイマとエッジはタイマが先に走る（HostBoard::advanceTo）。
+#include "host_fixture.h"
+
+namespace {
+
+constexpr usec_t HOLD_US    = Defaults::KILL_MIN_HOLD_US;
+constexpr usec_t TIMEOUT_US = Defaults::KILL_TIMEOUT_US;
+constexpr usec_t INHIBIT_US = Defaults::STARTUP_INHIBIT_MAX_US;
+constexpr usec_t DEBOUNCE   = Defaults::INT_DEBOUNCE_US;
+
+// KILLの解放理由と時刻（永続トレースの記録から）
+class Recorder : public HostObserver {
+ public:
+  void onTrace(usec_t at, TraceKind kind, uint8_t code) override {
+    if (kind != TraceKind::KillRelease) return;
+    ++releases;
+    lastRelease   = static_cast<TraceRelease>(code & 0x0F);
+    lastReleaseAt = at;
+  }
+
+  uint32_t     releases = 0;
+  TraceRelease lastRelease = TraceRelease::ResetFall;
+  usec_t       lastReleaseAt = 0;
+};
+Recorder g_rec;
+
+// RESET=H が最低継続を満たした時刻でINTを押し、KILLされたことを確かめる
+template <typename R>
+usec_t pressToKill() {
+  powerOn<R>(0);
+  const usec_t k = RISE_AT + RESET_MIN;
+  R::intLevel(k, false);
+  TEST_ASSERT_TRUE(R::kill());
+  return k;
+}
+
+} // namespace
+
+void setUp() {
+  board().reset();
+  g_rec = Recorder();
+  board().observe(&g_rec);
+}
+
+void tearDown() {}
+
+//==================== 起動抑止 ====================
+void test_inhibit_blocks_until_last_microsecond() {
+  using R = HostRig<TestChannel<1>>;
+  powerOn<R>(INHIBIT_US);
+  R::intLevel(RISE_AT + INHIBIT_US - 1, false);
+  TEST_ASSERT_FALSE(R::kill());
+  TEST_ASSERT_EQUAL_UINT32(1, R::Sv::stats().suppressedInhibit);
+  TEST_ASSERT_EQUAL_UINT32(1, board().ledPowerOn[0]);
+}
+
+void test_inhibit_ends_at_limit() {
+  using R = HostRig<TestChannel<2>>;
+  powerOn<R>(INHIBIT_US);
+  R::intLevel(RISE_AT + INHIBIT_US, false);
+  TEST_ASSERT_TRUE(R::kill());
+  TEST_ASSERT_EQUAL_UINT32(0, R::Sv::stats().suppressedInhibit);
+}
+
+void test_inhibit_ends_on_reset_fall() {
+  using R = HostRig<TestChannel<3>>;
+  powerOn<R>(INHIBIT_US);
+  R::reset(RISE_AT + 1000, false);
+  TEST_ASSERT_TRUE(R::Sv::idle());
+  TEST_ASSERT_EQUAL_UINT32(1, board().ledPowerOff[0]);
+}
+
+//==================== RESET=H の最低継続 ====================
+void test_reset_high_one_short_is_rejected() {
+  using R = HostRig<TestChannel<4>>;
+  powerOn<R>(0);
+  R::intLevel(RISE_AT + RESET_MIN - 1, false);
+  TEST_ASSERT_FALSE(R::kill());
+  TEST_ASSERT_EQUAL_UINT32(1, R::Sv::stats().suppressedResetShort);
+}
+
+void test_reset_high_exact_minimum_kills() {
+  using R = HostRig<TestChannel<5>>;
+  powerOn<R>(0);
+  R::intLevel(RISE_AT + RESET_MIN, false);
+  TEST_ASSERT_TRUE(R::kill());
+  TEST_ASSERT_EQUAL_UINT32(1, R::Sv::stats().kills);
+}
+
+void test_reset_glitch_restarts_minimum() {
+  using R = HostRig<TestChannel<6>>;
+  powerOn<R>(0);
+  R::reset(RISE_AT + RESET_MIN - 100, false);
+  R::reset(RISE_AT + RESET_MIN - 50, true);
+  R::intLevel(RISE_AT + RESET_MIN + 10, false); // 最初の立上りからは足りているが、瞬断後からは足りない
+  TEST_ASSERT_FALSE(R::kill());
+  TEST_ASSERT_EQUAL_UINT32(1, R::Sv::stats().suppressedResetShort);
+}
+
+//==================== INTデバウンス ====================
+void test_debounce_boundary() {
+  using R = HostRig<TestChannel<7>>;
+  powerOn<R>(0);
+  const usec_t a = RISE_AT + 1000; // RESET継続不足で受け付けのみ
+  R::intLevel(a, false);
+  R::intLevel(a + 10, true);
+  R::intLevel(a + DEBOUNCE - 1, false);
+  R::intLevel(a + DEBOUNCE - 1 + 10, true);
+  R::intLevel(a + 2 * DEBOUNCE - 1, false); // 最後に受け付けた a からは DEBOUNCE 以上
+  const SupervisorStats s = R::Sv::stats();
+  TEST_ASSERT_EQUAL_UINT32(3, s.intEdges);
+  TEST_ASSERT_EQUAL_UINT32(1, s.intDebounced);
+  TEST_ASSERT_EQUAL_UINT32(1, s.kills);
+}
+
+//==================== KILLの解放 ====================
+void test_release_on_reset_fall_after_hold() {
+  using R = HostRig<TestChannel<8>>;
+  const usec_t k = pressToKill<R>();
+  R::advanceTo(k + HOLD_US);   // 最低保持経過、RESET=H なので保持を続ける
+  TEST_ASSERT_TRUE(R::kill());
+  R::reset(k + HOLD_US + 1, false);
+  TEST_ASSERT_FALSE(R::kill());
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(TraceRelease::ResetFall), static_cast<int>(g_rec.lastRelease));
+  TEST_ASSERT_EQUAL_INT64(k + HOLD_US + 1, g_rec.lastReleaseAt);
+
+  PowerCycleProfile p[PROFILE_HISTORY];
+  uint32_t total = 0;
+  TEST_ASSERT_EQUAL_UINT32(1, R::Sv::profile(p, total));
+  TEST_ASSERT_EQUAL_UINT32(static_cast<uint32_t>(RESET_MIN), p[0].onUs);
+  TEST_ASSERT_EQUAL_UINT32(0, p[0].intToKillUs);
+  TEST_ASSERT_EQUAL_UINT32(static_cast<uint32_t>(HOLD_US + 1), p[0].killToResetUs);
+  TEST_ASSERT_EQUAL_UINT32(static_cast<uint32_t>(HOLD_US + 1), p[0].killHeldUs);
+  TEST_ASSERT_EQUAL_INT(0, board().killBoostDepth);
+}
+
+void test_reset_fall_before_hold_waits_for_hold() {
+  using R = HostRig<TestChannel<9>>;
+  const usec_t k = pressToKill<R>();
+  R::reset(k + 1000, false);
+  TEST_ASSERT_TRUE(R::kill());
+  R::advanceTo(k + HOLD_US - 1);
+  TEST_ASSERT_TRUE(R::kill());
+  R::advanceTo(k + HOLD_US);
+  TEST_ASSERT_FALSE(R::kill());
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(TraceRelease::HoldElapsed), static_cast<int>(g_rec.lastRelease));
+
+  PowerCycleProfile p[PROFILE_HISTORY];
+  uint32_t total = 0;
+  TEST_ASSERT_EQUAL_UINT32(1, R::Sv::profile(p, total));
+  TEST_ASSERT_EQUAL_UINT32(1000, p[0].killToResetUs);
+  TEST_ASSERT_EQUAL_UINT32(static_cast<uint32_t>(HOLD_US), p[0].killHeldUs);
+}
+
+void test_release_on_timeout_without_reset_fall() {
+  using R = HostRig<TestChannel<10>>;
+  const usec_t k = pressToKill<R>();
+  R::advanceTo(k + TIMEOUT_US - 1);
+  TEST_ASSERT_TRUE(R::kill());
+  R::advanceTo(k + TIMEOUT_US);
+  TEST_ASSERT_FALSE(R::kill());
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(TraceRelease::Timeout), static_cast<int>(g_rec.lastRelease));
+  const SupervisorStats s = R::Sv::stats();
+  TEST_ASSERT_EQUAL_UINT32(1, s.releaseTimeout);
+  TEST_ASSERT_EQUAL_UINT32(0, s.releaseResetLow);
+
+  PowerCycleProfile p[PROFILE_HISTORY];
+  uint32_t total = 0;
+  TEST_ASSERT_EQUAL_UINT32(1, R::Sv::profile(p, total));
+  TEST_ASSERT_EQUAL_UINT32(PROFILE_NONE, p[0].killToResetUs);
+}
+
+//==================== フェイルセーフ ====================
+#if !KILL_ASSERT_IN_ISR // ISRでアサートする構成では監視タスクの停止でアサートが遅れない
+// 監視タスクが止まっている間のKILL要求はバックストップがアサートし、
+// 後から処理された同じINTのイベントでは二重にアサートしない（killBegin の要求時刻の比較）
+void test_backstop_assert_then_late_event() {
+  using R = HostRig<TestChannel<11>>;
+  powerOn<R>(0);
+  board().holdTask(true);
+  const usec_t k = RISE_AT + RESET_MIN;
+  R::intLevel(k, false);
+  TEST_ASSERT_FALSE(R::kill());
+
+  R::advanceTo(k + BACKSTOP_ASSERT_US);
+  R::Sv::backstopCheck(board().now());
+  TEST_ASSERT_FALSE(R::kill());
+  R::advanceTo(k + BACKSTOP_ASSERT_US + 1);
+  R::Sv::backstopCheck(board().now());
+  TEST_ASSERT_TRUE(R::kill());
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(FailsafeReason::BackstopAssert), static_cast<int>(board().lastFailsafe));
+
+  const usec_t assertedAt = k + BACKSTOP_ASSERT_US + 1;
+  R::reset(assertedAt + HOLD_US + 1, false);
+  TEST_ASSERT_FALSE(R::kill());
+
+  board().holdTask(false); // 溜まっていた INT（要求時刻 k < 最後のアサート）を処理
+  TEST_ASSERT_FALSE(R::kill());
+  const SupervisorStats s = R::Sv::stats();
+  TEST_ASSERT_EQUAL_UINT32(1, s.kills);
+  TEST_ASSERT_EQUAL_UINT32(1, s.backstopAsserts);
+  TEST_ASSERT_EQUAL_UINT32(0, s.maxKillLatencyUs);
+
+  // アサートで要求は下ろされている（以後の点検で再アサートしない）
+  R::advanceTo(assertedAt + 10 * BACKSTOP_ASSERT_US);
+  R::Sv::backstopCheck(board().now());
+  TEST_ASSERT_FALSE(R::kill());
+  TEST_ASSERT_EQUAL_UINT32(1, board().failsafeNotes);
+  TEST_ASSERT_EQUAL_INT(0, board().killBoostDepth);
+}
+#endif
+
+// タイマタスクが止まってタイムアウトが来なければ、バックストップが余裕を見て強制解放する
+void test_backstop_release_when_timers_stall() {
+  using R = HostRig<TestChannel<12>>;
+  const usec_t k = pressToKill<R>();
+  board().holdTimers(true);
+  R::advanceTo(k + TIMEOUT_US + BACKSTOP_RELEASE_MARGIN_US);
+  R::Sv::backstopCheck(board().now());
+  TEST_ASSERT_TRUE(R::kill());
+  R::advanceTo(k + TIMEOUT_US + BACKSTOP_RELEASE_MARGIN_US + 1);
+  R::Sv::backstopCheck(board().now());
+  TEST_ASSERT_FALSE(R::kill());
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(TraceRelease::Backstop), static_cast<int>(g_rec.lastRelease));
+
+  board().holdTimers(false); // 解放でタイマは止まっている
+  TEST_ASSERT_EQUAL_UINT32(1, g_rec.releases);
+  const SupervisorStats s = R::Sv::stats();
+  TEST_ASSERT_EQUAL_UINT32(1, s.backstopReleases);
+  TEST_ASSERT_EQUAL_UINT32(0, s.releaseTimeout);
+}
+
+//==================== イベントリングの取りこぼし ====================
+#if !KILL_ASSERT_IN_ISR
+// リング満杯で捨てたINTのKILL判定も、要求の時刻から監視タスクがアサートする
+void test_dropped_kill_event_still_asserts() {
+  using R = HostRig<TestChannel<13>>;
+  R::start(0, false);
+  SupervisorTuning t = R::Sv::tuning();
+  t.startupInhibitMaxUs = 0;
+  R::Sv::setTuning(t);
+  board().holdTask(true);
+  usec_t at = RISE_AT;
+  for (uint32_t i = 0; i < EVENT_RING_LEN - 1; ++i) R::reset(at += 100, (i & 1) == 0); // 31件でリング満杯、最後はH
+  R::intLevel(at + RESET_MIN, false);
+  TEST_ASSERT_FALSE(R::kill());
+
+  board().holdTask(false);
+  TEST_ASSERT_TRUE(R::kill());
+  const SupervisorStats s = R::Sv::stats();
+  TEST_ASSERT_EQUAL_UINT32(1, s.eventsDropped);
+  TEST_ASSERT_EQUAL_UINT32(1, s.kills);
+}
+#endif
+
+// 捨てたRESETエッジはピン状態へ再同期する（起動抑止の解除と次の立上りの表示）
+void test_dropped_reset_edge_resyncs_level() {
+  using R = HostRig<TestChannel<14>>;
+  R::start(0, false);
+  board().holdTask(true);
+  usec_t at = RISE_AT;
+  for (uint32_t i = 0; i < EVENT_RING_LEN - 1; ++i) R::reset(at += 100, (i & 1) == 0); // 最後の記録はH
+  R::reset(at += 100, false);                                                      // 捨てられるL
+  board().holdTask(false);
+  TEST_ASSERT_TRUE(R::Sv::idle()); // H の処理で始まった起動抑止は再同期で解除
+
+  const uint32_t blinks = board().ledPowerOn[0];
+  R::reset(at + 100000, true);
+  TEST_ASSERT_EQUAL_UINT32(blinks + 1, board().ledPowerOn[0]);
+}
+
+//==================== MCUだけの再起動 ====================
+// 前回の起動から RESET=H が続いていれば点滅せず、抑止も起点からの残りだけ。
+// 割り込み有効化前に数えたINT立下りは arm() で判定する
+void test_warm_boot_carries_reset_and_counts_early_int() {
+  using R = HostRig<TestChannel<15>>;
+  board().bootResetSinceUs[0] = -2 * INHIBIT_US; // 抑止の上限より前から H
+  board().attach(R::isr, R::task);
+  board().input(0, TestChannel<15>::PIN_RESET, true);
+  board().input(0, TestChannel<15>::PIN_INT, true);
+  R::Sv::pinsBegin();
+  R::intLevel(1000, false); // 割り込み有効化前の押下（PCNTで数える）
+  R::Sv::begin(0);
+  R::Sv::arm();
+  R::Sv::handleEvents();
+  TEST_ASSERT_TRUE(R::kill());
+  TEST_ASSERT_EQUAL_UINT32(0, board().ledPowerOn[0]);
+}
+
+// 静的初期化（SUPERVISOR_FAST_BOOT）から数えた押下は pinsBegin() で消えずに arm() で判定される
+void test_early_int_count_survives_pins_begin() {
+  using R = HostRig<TestChannel<17>>;
+  board().bootResetSinceUs[0] = -2 * INHIBIT_US;
+  board().input(0, TestChannel<17>::PIN_RESET, true);
+  board().input(0, TestChannel<17>::PIN_INT, true);
+  R::Sv::intCountEarly();
+  R::intLevel(500, false);  // Arduinoコア初期化中の押下
+  R::intLevel(600, true);
+  board().attach(R::isr, R::task);
+  R::Sv::pinsBegin();
+  R::Sv::begin(0);
+  R::Sv::arm();
+  R::Sv::handleEvents();
+  TEST_ASSERT_TRUE(R::kill());
+  TEST_ASSERT_EQUAL_UINT32(1, R::Sv::stats().kills);
+}
+
+void test_cold_boot_with_reset_high_blinks_and_inhibits() {
+  using R = HostRig<TestChannel<16>>;
+  const usec_t boot = 1000; // 時刻0は「RESET=L」の印と重なるので避ける
+  R::start(boot, true);
+  TEST_ASSERT_EQUAL_UINT32(1, board().ledPowerOn[0]);
+  R::intLevel(boot + INHIBIT_US - 1, false);
+  TEST_ASSERT_FALSE(R::kill());
+  TEST_ASSERT_EQUAL_UINT32(1, R::Sv::stats().suppressedInhibit);
+}
+
+int main(int, char**) {
+  UNITY_BEGIN();
+  RUN_TEST(test_inhibit_blocks_until_last_microsecond);
+  RUN_TEST(test_inhibit_ends_at_limit);
+  RUN_TEST(test_inhibit_ends_on_reset_fall);
+  RUN_TEST(test_reset_high_one_short_is_rejected);
+  RUN_TEST(test_reset_high_exact_minimum_kills);
+  RUN_TEST(test_reset_glitch_restarts_minimum);
+  RUN_TEST(test_debounce_boundary);
+  RUN_TEST(test_release_on_reset_fall_after_hold);
+  RUN_TEST(test_reset_fall_before_hold_waits_for_hold);
+  RUN_TEST(test_release_on_timeout_without_reset_fall);
+#if !KILL_ASSERT_IN_ISR
+  RUN_TEST(test_backstop_assert_then_late_event);
+#endif
+  RUN_TEST(test_backstop_release_when_timers_stall);
+#if !KILL_ASSERT_IN_ISR
+  RUN_TEST(test_dropped_kill_event_still_asserts);
+#endif
+  RUN_TEST(test_dropped_reset_edge_resyncs_level);
+  RUN_TEST(test_warm_boot_carries_reset_and_counts_early_int);
+  RUN_TEST(test_early_int_count_survives_pins_begin);
+  RUN_TEST(test_cold_boot_with_reset_high_blinks_and_inhibits);
+  return UNITY_END();
+}